@@ -0,0 +1,84 @@
+#include "bench/BenchUtils.hpp"
+#include "lib/CircularBuffer.hpp"
+#include "lib/CircularBufferExt.hpp"
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+
+namespace {
+
+constexpr int kIterations = 2000;
+constexpr int kElements = 1024;
+
+// A request-scoped buffer that grows from empty and is thrown away with its arena.
+template<typename T, typename Make>
+void grow_in_resource(std::pmr::memory_resource* resource, Make make) {
+    pmr::CircularBufferExt<T> cb(resource);
+    for (int i = 0; i < kElements; ++i) {
+        cb.push_back(make(i));
+    }
+    do_not_optimize(cb.back());
+}
+
+template<typename T, typename Make>
+void grow_in_default_heap(Make make) {
+    CircularBufferExt<T> cb;
+    for (int i = 0; i < kElements; ++i) {
+        cb.push_back(make(i));
+    }
+    do_not_optimize(cb.back());
+}
+
+template<typename T, typename Make>
+void bench_growth(const char* type_name, Make make) {
+    std::array<std::byte, 1 << 20> storage;
+    std::pmr::unsynchronized_pool_resource pool;
+    std::string prefix = std::string("grow ") + type_name;
+
+    run_bench((prefix + " std::allocator").c_str(), kIterations, [&] { grow_in_default_heap<T>(make); });
+    run_bench((prefix + " monotonic").c_str(), kIterations, [&] {
+        std::pmr::monotonic_buffer_resource arena(storage.data(), storage.size());
+        grow_in_resource<T>(&arena, make);
+    });
+    run_bench((prefix + " pool").c_str(), kIterations, [&] { grow_in_resource<T>(&pool, make); });
+}
+
+// swap and move assignment between buffers of the same arena only exchange pointers.
+void bench_swap_and_move() {
+    std::pmr::unsynchronized_pool_resource pool;
+    std::pmr::unsynchronized_pool_resource other_pool;
+    pmr::CircularBufferExt<int> a(&pool);
+    pmr::CircularBufferExt<int> b(&pool);
+    pmr::CircularBufferExt<int> c(&other_pool);
+    for (int i = 0; i < kElements; ++i) {
+        a.push_back(i);
+        b.push_back(-i);
+        c.push_back(i);
+    }
+
+    run_bench("swap same resource", kIterations * 100, [&] {
+        a.swap(b);
+        do_not_optimize(a.front());
+    });
+    run_bench("swap different resources", kIterations, [&] {
+        a.swap(c);
+        do_not_optimize(a.front());
+    });
+    run_bench("move assign same resource", kIterations * 100, [&] {
+        pmr::CircularBufferExt<int> tmp(&pool);
+        tmp = std::move(a);
+        a = std::move(tmp);
+        do_not_optimize(a.front());
+    });
+}
+
+} // namespace
+
+int main() {
+    bench_growth<int>("int", [](int i) { return i; });
+    bench_growth<std::string>("string", [](int i) { return std::string(32, static_cast<char>('a' + i % 26)); });
+    bench_swap_and_move();
+    return 0;
+}
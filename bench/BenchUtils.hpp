@@ -0,0 +1,22 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+
+// Runs f `iterations` times and prints the mean wall time per iteration.
+template<typename F>
+void run_bench(const char* name, int iterations, F&& f) {
+    f();
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        f();
+    }
+    const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+    std::printf("%-48s %12.1f ns/iter\n", name, elapsed.count() / iterations);
+}
+
+// Keeps the optimizer from discarding a computed value.
+template<typename T>
+void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
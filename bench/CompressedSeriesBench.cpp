@@ -0,0 +1,58 @@
+#include "bench/BenchUtils.hpp"
+#include "lib/CircularBuffer.hpp"
+#include "lib/CompressedSeriesBuffer.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+// Usage: compressed_series_bench [value count]
+int main(int argc, char** argv) {
+    const std::size_t n = (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::size_t{1} << 22);
+
+    // Nanosecond timestamps about 1us apart with jitter, as a sampling loop would record them.
+    CircularBuffer<std::int64_t> plain(n);
+    CompressedSeriesBuffer<> compressed(n * sizeof(std::int64_t) / 4);
+    std::uint64_t state = 88172645463325252ULL;
+    std::int64_t timestamp = 1'700'000'000'000'000'000;
+    for (std::size_t i = 0; i < n; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        timestamp += 1000 + static_cast<std::int64_t>(state % 256);
+        plain.push_back(timestamp);
+        compressed.push_back(timestamp);
+    }
+
+    std::printf("%zu timestamps; plain %zu bytes, compressed %zu bytes for %zu values (%.1fx), %zu evicted\n", n,
+                n * sizeof(std::int64_t), compressed.compressed_bytes(), compressed.size(),
+                static_cast<double>(compressed.size() * sizeof(std::int64_t)) /
+                static_cast<double>(compressed.compressed_bytes()),
+                compressed.evicted());
+
+    run_bench("CircularBuffer<int64_t> sum", 20, [&] {
+        std::int64_t sum = 0;
+        const auto regions = plain.peek(plain.size());
+        for (const std::int64_t value: regions.first) {
+            sum += value;
+        }
+        for (const std::int64_t value: regions.second) {
+            sum += value;
+        }
+        do_not_optimize(sum);
+    });
+    run_bench("CompressedSeriesBuffer sum", 20, [&] {
+        std::int64_t sum = 0;
+        compressed.for_each_block([&sum](std::span<const std::int64_t> block) {
+            for (const std::int64_t value: block) {
+                sum += value;
+            }
+        });
+        do_not_optimize(sum);
+    });
+    run_bench("CompressedSeriesBuffer push", 5, [&] {
+        for (std::size_t i = 0; i < n; ++i) {
+            compressed.push_back(timestamp + static_cast<std::int64_t>(i) * 1000);
+        }
+    });
+}
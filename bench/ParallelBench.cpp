@@ -0,0 +1,64 @@
+#include "bench/BenchUtils.hpp"
+#include "lib/CircularBufferExt.hpp"
+#include "lib/ParallelAlgorithms.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+namespace {
+
+CircularBufferExt<double> make_wrapped(std::size_t n) {
+    CircularBufferExt<double> cb;
+    cb.reserve(n);
+    std::uint64_t state = 88172645463325252ULL;
+    for (std::size_t i = 0; i < n + n / 3; ++i) {
+        if (cb.size() == n) {
+            cb.pop_front();
+        }
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        cb.push_back(static_cast<double>(state % 1000003) / 7.0);
+    }
+    return cb;
+}
+
+} // namespace
+
+// Usage: parallel_bench [element count]
+int main(int argc, char** argv) {
+    const std::size_t n = (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::size_t{1} << 23);
+    const std::size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    auto source = make_wrapped(n);
+    auto work = make_wrapped(n);
+
+    std::printf("%zu doubles, wrapped buffer\n", n);
+    for (std::size_t threads = 1;; threads = std::min(threads * 2, max_threads)) {
+        ThreadPool pool(threads);
+        char name[64];
+
+        std::snprintf(name, sizeof(name), "for_each  threads=%zu", threads);
+        run_bench(name, 5, [&] { parallel::for_each(pool, work, [](double& x) { x = std::sqrt(x + 1.0); }); });
+
+        std::snprintf(name, sizeof(name), "transform threads=%zu", threads);
+        run_bench(name, 5, [&] { parallel::transform(pool, source, work, [](double x) { return x * 1.5 + 2.0; }); });
+
+        std::snprintf(name, sizeof(name), "reduce    threads=%zu", threads);
+        run_bench(name, 5, [&] { do_not_optimize(parallel::reduce(pool, source, 0.0)); });
+
+        std::snprintf(name, sizeof(name), "sort      threads=%zu", threads);
+        run_bench(name, 3, [&] {
+            parallel::transform(pool, source, work, [](double x) { return x; });
+            parallel::sort(pool, work);
+        });
+
+        if (threads == max_threads) {
+            break;
+        }
+    }
+    return 0;
+}
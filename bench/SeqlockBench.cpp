@@ -0,0 +1,85 @@
+#include "lib/SeqlockCircularBuffer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+
+namespace {
+
+struct Quote {
+    std::uint64_t sequence;
+    double bid;
+    double ask;
+    std::uint64_t size;
+};
+
+struct Result {
+    double snapshots_per_second;
+    double pushes_per_second;
+};
+
+// Runs `readers` threads copying the newest `window` quotes while one writer pushes `writer_rate` quotes per
+// second (0 = as fast as it can) for `duration`.
+Result run(std::size_t readers, std::size_t window, double writer_rate, std::chrono::milliseconds duration) {
+    SeqlockCircularBuffer<Quote> ring(1024);
+    std::atomic<bool> done{false};
+    std::atomic<std::uint64_t> snapshots{0};
+    std::uint64_t pushes = 0;
+
+    auto threads = std::make_unique<std::thread[]>(readers);
+    for (std::size_t r = 0; r < readers; ++r) {
+        threads[r] = std::thread([&] {
+            auto out = std::make_unique<Quote[]>(window);
+            std::uint64_t local = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                ring.snapshot(out.get(), window);
+                ++local;
+            }
+            snapshots.fetch_add(local, std::memory_order_relaxed);
+        });
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto deadline = start + duration;
+    for (auto now = start; now < deadline; now = std::chrono::steady_clock::now()) {
+        if (writer_rate == 0 || static_cast<double>(pushes) < writer_rate * std::chrono::duration<double>(now - start).count()) {
+            ring.push_back(Quote{pushes, 100.0, 100.5, pushes % 1000});
+            ++pushes;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    done.store(true, std::memory_order_relaxed);
+    for (std::size_t r = 0; r < readers; ++r) {
+        threads[r].join();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return {static_cast<double>(snapshots.load()) / seconds, static_cast<double>(pushes) / seconds};
+}
+
+} // namespace
+
+// Usage: seqlock_bench [window] [milliseconds per run]
+int main(int argc, char** argv) {
+    const std::size_t window = (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 64);
+    const std::chrono::milliseconds duration(argc > 2 ? std::strtoll(argv[2], nullptr, 10) : 300);
+    const std::size_t max_readers = std::max(1u, std::thread::hardware_concurrency());
+
+    std::printf("window=%zu quotes; writer rate 0 means unthrottled\n", window);
+    std::printf("%8s %14s %16s %16s\n", "readers", "writer rate", "pushes/s", "snapshots/s");
+    for (const double rate: {1e3, 1e5, 1e6, 0.0}) {
+        for (std::size_t readers = 1;; readers = std::min(readers * 2, max_readers)) {
+            const Result result = run(readers, window, rate, duration);
+            std::printf("%8zu %14.0f %16.0f %16.0f\n", readers, rate, result.pushes_per_second,
+                        result.snapshots_per_second);
+            if (readers == max_readers) {
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,97 @@
+#include "bench/BenchUtils.hpp"
+#include "lib/TimingWheel.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// The usual heap timer: cancel marks the id and the entry is skipped when it reaches the top.
+class HeapTimer {
+public:
+    explicit HeapTimer(std::size_t ids) : cancelled_(std::make_unique<bool[]>(ids)) {}
+
+    void schedule(std::uint64_t deadline, std::uint32_t id) {
+        cancelled_[id] = false;
+        heap_.emplace(deadline, id);
+    }
+
+    void cancel(std::uint32_t id) {
+        cancelled_[id] = true;
+    }
+
+    template<typename F>
+    void advance(std::uint64_t to, F&& on_expire) {
+        while (!heap_.empty() && heap_.top().first <= to) {
+            const std::uint32_t id = heap_.top().second;
+            heap_.pop();
+            if (!cancelled_[id]) {
+                on_expire(id);
+            }
+        }
+    }
+
+private:
+    using Entry = std::pair<std::uint64_t, std::uint32_t>;
+
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<>> heap_;
+    std::unique_ptr<bool[]> cancelled_;
+};
+
+} // namespace
+
+// Usage: timing_wheel_bench [timers]
+// Request-deadline pattern: every timer is scheduled, most are cancelled before they fire, and the clock
+// advances one tick (1 ms) at a time.
+int main(int argc, char** argv) {
+    const std::size_t n = (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000);
+    auto deadlines = std::make_unique<std::uint64_t[]>(n);
+    std::uint64_t state = 88172645463325252ULL;
+    for (std::size_t i = 0; i < n; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        deadlines[i] = 1 + state % 30'000;
+    }
+
+    run_bench("TimingWheel   schedule/cancel 90%/expire", 3, [&] {
+        TimingWheel<std::uint32_t> wheel;
+        auto handles = std::make_unique<TimingWheel<std::uint32_t>::Handle[]>(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            handles[i] = wheel.schedule(deadlines[i], static_cast<std::uint32_t>(i));
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            if (i % 10 != 0) {
+                wheel.cancel(handles[i]);
+            }
+        }
+        std::uint64_t sum = 0;
+        for (std::uint64_t tick = 1; tick <= 30'000; ++tick) {
+            wheel.advance(tick, [&sum](std::uint32_t id) { sum += id; });
+        }
+        do_not_optimize(sum);
+    });
+
+    run_bench("priority_queue schedule/cancel 90%/expire", 3, [&] {
+        HeapTimer heap(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            heap.schedule(deadlines[i], static_cast<std::uint32_t>(i));
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            if (i % 10 != 0) {
+                heap.cancel(static_cast<std::uint32_t>(i));
+            }
+        }
+        std::uint64_t sum = 0;
+        for (std::uint64_t tick = 1; tick <= 30'000; ++tick) {
+            heap.advance(tick, [&sum](std::uint32_t id) { sum += id; });
+        }
+        do_not_optimize(sum);
+    });
+}
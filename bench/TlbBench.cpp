@@ -0,0 +1,143 @@
+#include "bench/BenchUtils.hpp"
+#include "lib/CircularBuffer.hpp"
+#include "lib/HugePageAllocator.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+// dTLB load misses of the calling thread; reports nothing when perf events are unavailable (containers,
+// perf_event_paranoid, virtual machines without a PMU).
+class TlbMissCounter {
+public:
+    TlbMissCounter() {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    TlbMissCounter(const TlbMissCounter&) = delete;
+
+    TlbMissCounter& operator=(const TlbMissCounter&) = delete;
+
+    ~TlbMissCounter() {
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+
+    bool available() const noexcept {
+        return fd_ >= 0;
+    }
+
+    void start() noexcept {
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    std::uint64_t stop() noexcept {
+        std::uint64_t value = 0;
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd_, &value, sizeof(value)) != sizeof(value)) {
+                value = 0;
+            }
+        }
+        return value;
+    }
+
+private:
+    int fd_;
+};
+
+template<typename Buffer>
+void measure(const char* name, Buffer& cb, std::size_t random_reads) {
+    TlbMissCounter counter;
+    const std::size_t n = cb.size();
+
+    std::uint64_t sum = 0;
+    counter.start();
+    const auto sequential_start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < n; ++i) {
+        sum += cb[i];
+    }
+    const auto sequential_time = std::chrono::steady_clock::now() - sequential_start;
+    const std::uint64_t sequential_misses = counter.stop();
+
+    std::uint64_t state = 0x9E3779B97F4A7C15ULL;
+    counter.start();
+    const auto random_start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < random_reads; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        sum += cb[state % n];
+    }
+    const auto random_time = std::chrono::steady_clock::now() - random_start;
+    const std::uint64_t random_misses = counter.stop();
+    do_not_optimize(sum);
+
+    const auto ns = [](auto duration) { return std::chrono::duration<double, std::nano>(duration).count(); };
+    if (counter.available()) {
+        std::printf("%-24s sequential %6.2f ns/read %12llu dTLB misses | random %6.2f ns/read %12llu dTLB misses\n",
+                    name, ns(sequential_time) / n, static_cast<unsigned long long>(sequential_misses),
+                    ns(random_time) / random_reads, static_cast<unsigned long long>(random_misses));
+    } else {
+        std::printf("%-24s sequential %6.2f ns/read | random %6.2f ns/read (dTLB counter unavailable)\n",
+                    name, ns(sequential_time) / n, ns(random_time) / random_reads);
+    }
+}
+
+template<typename Buffer>
+void fill(Buffer& cb) {
+    for (std::size_t i = 0; i < cb.capacity(); ++i) {
+        cb.push_back(i);
+    }
+}
+
+} // namespace
+
+// Usage: tlb_bench [buffer size in MiB] [NUMA node]
+int main(int argc, char** argv) {
+    const std::size_t mebibytes = (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 512);
+    const int numa_node = (argc > 2 ? std::atoi(argv[2]) : -1);
+    const std::size_t capacity = (mebibytes << 20) / sizeof(std::uint64_t);
+    const std::size_t random_reads = std::size_t{1} << 24;
+
+    {
+        CircularBuffer<std::uint64_t> cb(capacity);
+        fill(cb);
+        measure("std::allocator", cb, random_reads);
+    }
+    {
+        using Alloc = HugePageAllocator<std::uint64_t>;
+        CircularBuffer<std::uint64_t, Alloc> cb(capacity, Alloc({.huge_pages = false, .numa_node = numa_node}));
+        fill(cb);
+        measure("4K pages (mmap)", cb, random_reads);
+    }
+    {
+        using Alloc = HugePageAllocator<std::uint64_t>;
+        CircularBuffer<std::uint64_t, Alloc> cb(capacity, Alloc({.huge_pages = true, .populate = true,
+                                                                 .numa_node = numa_node}));
+        fill(cb);
+        measure("huge pages", cb, random_reads);
+    }
+    return 0;
+}
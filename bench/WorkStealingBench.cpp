@@ -0,0 +1,169 @@
+#include "bench/BenchUtils.hpp"
+#include "lib/CircularBufferExt.hpp"
+#include "lib/WorkStealingDeque.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace {
+
+// The status quo: a CircularBufferExt behind a mutex, owner at the back, thieves at the front.
+template<typename T>
+class LockedDeque {
+public:
+    void push(const T& value) {
+        std::lock_guard lock(mutex_);
+        buffer_.push_back(value);
+    }
+
+    std::optional<T> pop() {
+        std::lock_guard lock(mutex_);
+        return buffer_.empty() ? std::nullopt : std::optional<T>(buffer_.pop_back());
+    }
+
+    std::optional<T> steal() {
+        std::lock_guard lock(mutex_);
+        return buffer_.empty() ? std::nullopt : std::optional<T>(buffer_.pop_front());
+    }
+
+private:
+    std::mutex mutex_;
+    CircularBufferExt<T> buffer_;
+};
+
+// Runs root and everything it spawns on `threads` workers, each with its own deque. process(task, spawn) may
+// call spawn(task) any number of times.
+template<template<typename> typename Deque, typename Task, typename Process>
+void run_tasks(std::size_t threads, Task root, Process process) {
+    auto deques = std::make_unique<Deque<Task>[]>(threads);
+    std::atomic<std::int64_t> outstanding{1};
+    deques[0].push(root);
+
+    auto worker = [&](std::size_t self) {
+        auto spawn = [&](const Task& task) {
+            outstanding.fetch_add(1, std::memory_order_relaxed);
+            deques[self].push(task);
+        };
+        std::uint64_t state = 0x9E3779B97F4A7C15ULL * (self + 1);
+        while (outstanding.load(std::memory_order_acquire) != 0) {
+            std::optional<Task> task = deques[self].pop();
+            for (std::size_t attempt = 0; !task && attempt < 2 * threads; ++attempt) {
+                state ^= state << 13;
+                state ^= state >> 7;
+                state ^= state << 17;
+                const std::size_t victim = state % threads;
+                if (victim != self) {
+                    task = deques[victim].steal();
+                }
+            }
+            if (!task) {
+                std::this_thread::yield();
+                continue;
+            }
+            process(*task, spawn);
+            outstanding.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    };
+
+    auto workers = std::make_unique<std::thread[]>(threads - 1);
+    for (std::size_t i = 1; i < threads; ++i) {
+        workers[i - 1] = std::thread(worker, i);
+    }
+    worker(0);
+    for (std::size_t i = 1; i < threads; ++i) {
+        workers[i - 1].join();
+    }
+}
+
+std::uint64_t fib(int n) {
+    return n < 2 ? static_cast<std::uint64_t>(n) : fib(n - 1) + fib(n - 2);
+}
+
+template<template<typename> typename Deque>
+std::uint64_t parallel_fib(std::size_t threads, int n) {
+    std::atomic<std::uint64_t> result{0};
+    run_tasks<Deque>(threads, n, [&result](int k, auto&& spawn) {
+        // Fine-grained on purpose: the deque operations are a large share of the work.
+        for (; k >= 12; k -= 2) {
+            spawn(k - 1);
+        }
+        result.fetch_add(fib(k), std::memory_order_relaxed);
+    });
+    return result.load();
+}
+
+struct Range {
+    std::uint32_t begin;
+    std::uint32_t end;
+};
+
+template<template<typename> typename Deque>
+void parallel_quicksort(std::size_t threads, std::uint32_t* data, std::uint32_t n) {
+    run_tasks<Deque>(threads, Range{0, n}, [data](Range range, auto&& spawn) {
+        while (range.end - range.begin > 2048) {
+            std::uint32_t* first = data + range.begin;
+            std::uint32_t* last = data + range.end;
+            const std::uint32_t pivot = std::max(std::min(first[0], last[-1]),
+                                                 std::min(std::max(first[0], last[-1]), first[(last - first) / 2]));
+            std::uint32_t* middle = std::partition(first, last, [pivot](std::uint32_t x) { return x < pivot; });
+            std::uint32_t* upper = std::partition(middle, last, [pivot](std::uint32_t x) { return x == pivot; });
+            spawn(Range{static_cast<std::uint32_t>(upper - data), range.end});
+            range.end = static_cast<std::uint32_t>(middle - data);
+        }
+        std::sort(data + range.begin, data + range.end);
+    });
+}
+
+} // namespace
+
+// Usage: work_stealing_bench [fib n] [quicksort size]
+int main(int argc, char** argv) {
+    const int fib_n = (argc > 1 ? std::atoi(argv[1]) : 32);
+    const auto sort_n = static_cast<std::uint32_t>(argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1u << 23);
+    const std::size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    auto input = std::make_unique<std::uint32_t[]>(sort_n);
+    auto data = std::make_unique<std::uint32_t[]>(sort_n);
+    std::uint64_t state = 88172645463325252ULL;
+    for (std::uint32_t i = 0; i < sort_n; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        input[i] = static_cast<std::uint32_t>(state);
+    }
+
+    std::printf("fib(%d) = %llu, quicksort of %u values\n", fib_n,
+                static_cast<unsigned long long>(parallel_fib<WorkStealingDeque>(1, fib_n)), sort_n);
+    for (std::size_t threads = 1;; threads = std::min(threads * 2, max_threads)) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "fib       chase-lev threads=%zu", threads);
+        run_bench(name, 3, [&] { do_not_optimize(parallel_fib<WorkStealingDeque>(threads, fib_n)); });
+        std::snprintf(name, sizeof(name), "fib       locked    threads=%zu", threads);
+        run_bench(name, 3, [&] { do_not_optimize(parallel_fib<LockedDeque>(threads, fib_n)); });
+
+        std::snprintf(name, sizeof(name), "quicksort chase-lev threads=%zu", threads);
+        run_bench(name, 3, [&] {
+            std::copy(input.get(), input.get() + sort_n, data.get());
+            parallel_quicksort<WorkStealingDeque>(threads, data.get(), sort_n);
+        });
+        if (!std::is_sorted(data.get(), data.get() + sort_n)) {
+            std::printf("quicksort produced unsorted output\n");
+            return 1;
+        }
+        std::snprintf(name, sizeof(name), "quicksort locked    threads=%zu", threads);
+        run_bench(name, 3, [&] {
+            std::copy(input.get(), input.get() + sort_n, data.get());
+            parallel_quicksort<LockedDeque>(threads, data.get(), sort_n);
+        });
+        if (threads == max_threads) {
+            break;
+        }
+    }
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cassert>
+#include <stdexcept>
+
+// Failure reasons of the non-throwing try_* API.
+enum class BufferError {
+    empty,
+    full,
+    out_of_range,
+};
+
+// Precondition checks of the containers and their iterators. They throw std::out_of_range by default;
+// with CIRCULAR_BUFFER_UNCHECKED defined they become assert()s, i.e. nothing at all under NDEBUG.
+#ifdef CIRCULAR_BUFFER_UNCHECKED
+#define CIRCULAR_BUFFER_CHECK(condition, message) assert((condition) && (message))
+#else
+#define CIRCULAR_BUFFER_CHECK(condition, message) \
+    do { \
+        if (!(condition)) { \
+            throw std::out_of_range(message); \
+        } \
+    } while (false)
+#endif
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <ostream>
+#include <string_view>
+
+enum class BufferOperation {
+    push_back,
+    push_front,
+    pop_back,
+    pop_front,
+    insert,
+    erase,
+    reserve,
+};
+
+inline constexpr std::size_t kBufferOperationCount = 7;
+
+constexpr std::string_view to_string(BufferOperation operation) noexcept {
+    constexpr std::string_view names[kBufferOperationCount] = {
+            "push_back", "push_front", "pop_back", "pop_front", "insert", "erase", "reserve"};
+    return names[static_cast<std::size_t>(operation)];
+}
+
+// Returned by trace() when the policy has no scope(BufferOperation) hook.
+struct NoTraceScope {};
+
+// Default stats policy: every hook is an empty inline call and the member takes no space.
+struct NoBufferStats {
+    void on_push(std::size_t /*count*/, std::size_t /*size*/) noexcept {}
+
+    void on_pop(std::size_t /*count*/) noexcept {}
+
+    void on_overwrite() noexcept {}
+
+    void on_reallocate(std::size_t /*old_capacity*/, std::size_t /*new_capacity*/, std::size_t /*moved*/) noexcept {}
+
+    void on_footprint(std::size_t /*bytes*/) noexcept {}
+};
+
+// Counters are written only by the thread that owns the buffer, so a relaxed load + store is enough on that side;
+// any other thread may read them with relaxed loads at any time.
+class BufferStats {
+public:
+    BufferStats() = default;
+
+    BufferStats(const BufferStats&) = delete;
+
+    BufferStats& operator=(const BufferStats&) = delete;
+
+    void on_push(std::size_t count, std::size_t size) noexcept {
+        bump(pushes_, count);
+        if (size > peak_size_.load(std::memory_order_relaxed)) {
+            peak_size_.store(size, std::memory_order_relaxed);
+        }
+    }
+
+    void on_pop(std::size_t count) noexcept {
+        bump(pops_, count);
+    }
+
+    void on_overwrite() noexcept {
+        bump(overwrites_, 1);
+    }
+
+    void on_reallocate(std::size_t old_capacity, std::size_t new_capacity, std::size_t moved) noexcept {
+        if (new_capacity > old_capacity) {
+            bump(growths_, 1);
+        } else if (new_capacity < old_capacity) {
+            bump(shrinks_, 1);
+        }
+        bump(elements_moved_, moved);
+    }
+
+    void on_footprint(std::size_t bytes) noexcept {
+        footprint_bytes_.store(bytes, std::memory_order_relaxed);
+    }
+
+    std::size_t pushes() const noexcept {
+        return pushes_.load(std::memory_order_relaxed);
+    }
+
+    std::size_t pops() const noexcept {
+        return pops_.load(std::memory_order_relaxed);
+    }
+
+    std::size_t overwrites() const noexcept {
+        return overwrites_.load(std::memory_order_relaxed);
+    }
+
+    std::size_t growths() const noexcept {
+        return growths_.load(std::memory_order_relaxed);
+    }
+
+    std::size_t shrinks() const noexcept {
+        return shrinks_.load(std::memory_order_relaxed);
+    }
+
+    std::size_t elements_moved() const noexcept {
+        return elements_moved_.load(std::memory_order_relaxed);
+    }
+
+    std::size_t peak_size() const noexcept {
+        return peak_size_.load(std::memory_order_relaxed);
+    }
+
+    std::size_t footprint_bytes() const noexcept {
+        return footprint_bytes_.load(std::memory_order_relaxed);
+    }
+
+    // One "<prefix>_<counter> <value>" line per counter.
+    void dump(std::ostream& out, std::string_view prefix = "circular_buffer") const {
+        out << prefix << "_pushes " << pushes() << '\n'
+            << prefix << "_pops " << pops() << '\n'
+            << prefix << "_overwrites " << overwrites() << '\n'
+            << prefix << "_growths " << growths() << '\n'
+            << prefix << "_shrinks " << shrinks() << '\n'
+            << prefix << "_elements_moved " << elements_moved() << '\n'
+            << prefix << "_peak_size " << peak_size() << '\n'
+            << prefix << "_footprint_bytes " << footprint_bytes() << '\n';
+    }
+
+private:
+    static void bump(std::atomic<std::size_t>& counter, std::size_t n) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    std::atomic<std::size_t> pushes_{0};
+    std::atomic<std::size_t> pops_{0};
+    std::atomic<std::size_t> overwrites_{0};
+    std::atomic<std::size_t> growths_{0};
+    std::atomic<std::size_t> shrinks_{0};
+    std::atomic<std::size_t> elements_moved_{0};
+    std::atomic<std::size_t> peak_size_{0};
+    std::atomic<std::size_t> footprint_bytes_{0};
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+// Slot wrapper that gives every element of a buffer its own cache line(s), so threads updating neighbouring
+// slots do not false-share. CircularBuffer<CacheAligned<T>> keeps the usual interface: elements are built from
+// T implicitly and references convert to T&.
+template<typename T, std::size_t Alignment = 64>
+struct alignas(Alignment) CacheAligned {
+    static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+
+    T value;
+
+    CacheAligned() = default;
+
+    template<typename... Args>
+    requires std::is_constructible_v<T, Args...> &&
+             (sizeof...(Args) != 1 || (!std::is_same_v<std::remove_cvref_t<Args>, CacheAligned> && ...))
+    CacheAligned(Args&& ... args) : value(std::forward<Args>(args)...) {}
+
+    template<typename U>
+    requires std::is_assignable_v<T&, U&&> && (!std::is_same_v<std::remove_cvref_t<U>, CacheAligned>)
+    CacheAligned& operator=(U&& other) {
+        value = std::forward<U>(other);
+        return *this;
+    }
+
+    operator T&() noexcept {
+        return value;
+    }
+
+    operator const T&() const noexcept {
+        return value;
+    }
+
+    T* operator->() noexcept {
+        return &value;
+    }
+
+    const T* operator->() const noexcept {
+        return &value;
+    }
+
+    T& get() noexcept {
+        return value;
+    }
+
+    const T& get() const noexcept {
+        return value;
+    }
+
+    bool operator==(const CacheAligned& other) const = default;
+
+    bool operator==(const T& other) const {
+        return value == other;
+    }
+
+    auto operator<=>(const CacheAligned& other) const = default;
+};
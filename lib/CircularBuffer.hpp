@@ -2,52 +2,55 @@
 
 #include "CircularBufferBase.hpp"
 
-template<typename T, typename Alloc = std::allocator<T>>
-class CircularBuffer : protected CircularBufferBase<T, Alloc> {
+#include <memory_resource>
+
+template<typename T, typename Alloc = std::allocator<T>, typename Stats = NoBufferStats>
+class CircularBuffer : protected CircularBufferBase<T, Alloc, Stats> {
 public:
     USING_FIELDS;
 
-    explicit CircularBuffer(const Alloc& allocator = Alloc()) : CircularBufferBase<T, Alloc>(allocator) {}
+    explicit CircularBuffer(const Alloc& allocator = Alloc()) : CircularBufferBase<T, Alloc, Stats>(allocator) {}
 
-    explicit CircularBuffer(CircularBufferBase<T, Alloc>::size_type n, const Alloc& allocator = Alloc())
-            : CircularBufferBase<T, Alloc>(n, allocator) {}
+    explicit CircularBuffer(CircularBufferBase<T, Alloc, Stats>::size_type n, const Alloc& allocator = Alloc())
+            : CircularBufferBase<T, Alloc, Stats>(n, allocator) {}
 
-    CircularBuffer(CircularBufferBase<T, Alloc>::size_type n,
-                   CircularBufferBase<T, Alloc>::value_type value,
-                   const Alloc& allocator = Alloc()) : CircularBufferBase<T, Alloc>(n, value, allocator) {}
+    CircularBuffer(CircularBufferBase<T, Alloc, Stats>::size_type n,
+                   CircularBufferBase<T, Alloc, Stats>::value_type value,
+                   const Alloc& allocator = Alloc()) : CircularBufferBase<T, Alloc, Stats>(n, value, allocator) {}
 
-    CircularBuffer(const CircularBuffer<T, Alloc>& other)
+    CircularBuffer(const CircularBuffer<T, Alloc, Stats>& other)
             :
-            CircularBufferBase<T, Alloc>(other) {}
+            CircularBufferBase<T, Alloc, Stats>(other) {}
 
-    CircularBuffer(CircularBuffer<T, Alloc>&& other) noexcept: CircularBufferBase<T, Alloc>(std::move(other)) {}
+    CircularBuffer(CircularBuffer<T, Alloc, Stats>&& other) noexcept: CircularBufferBase<T, Alloc, Stats>(std::move(other)) {}
 
     template<typename LegacyInputIterator>
     CircularBuffer(LegacyInputIterator i, LegacyInputIterator j, const Alloc& allocator = Alloc())
-            : CircularBufferBase<T, Alloc>(i, j, allocator) {}
+            : CircularBufferBase<T, Alloc, Stats>(i, j, allocator) {}
 
     CircularBuffer(const std::initializer_list<value_type>& list, const Alloc& allocator = Alloc())
-            : CircularBufferBase<T, Alloc>(list, allocator) {}
+            : CircularBufferBase<T, Alloc, Stats>(list, allocator) {}
 
     ~CircularBuffer() {
-        clear();
-        AllocTraits::deallocate(allocator_, buff_start_, capacity() + 1);
+        if (buff_start_ != nullptr) {
+            clear();
+            AllocTraits::deallocate(allocator_, buff_start_, capacity() + 1);
+        }
     }
 
     CircularBuffer& operator=(const CircularBuffer& other) {
-        static_cast<CircularBufferBase<T, Alloc>&>(*this).operator=(
-                static_cast<CircularBufferBase<T, Alloc>&>(other));
+        CircularBufferBase<T, Alloc, Stats>::operator=(other);
         return *this;
     }
 
-    CircularBuffer& operator=(CircularBuffer&& other) noexcept {
-        static_cast<CircularBufferBase<T, Alloc>&>(*this).operator=(
-                std::move(static_cast<CircularBufferBase<T, Alloc>&>(other)));
+    CircularBuffer& operator=(CircularBuffer&& other) noexcept(AllocTraits::propagate_on_container_move_assignment::value ||
+                                                 AllocTraits::is_always_equal::value) {
+        CircularBufferBase<T, Alloc, Stats>::operator=(std::move(other));
         return *this;
     }
 
     void swap(CircularBuffer& other) {
-        static_cast<CircularBufferBase<T, Alloc>&>(*this).swap(static_cast<CircularBufferBase<T, Alloc>&>(other));
+        static_cast<CircularBufferBase<T, Alloc, Stats>&>(*this).swap(static_cast<CircularBufferBase<T, Alloc, Stats>&>(other));
     }
 
     void push_back(const T& value);
@@ -79,20 +82,31 @@ public:
 
     iterator insert(const_iterator p, const std::initializer_list<value_type>& il);
 
+    // insert() that reports a position outside [begin(), end()] instead of throwing.
+    std::expected<iterator, BufferError> try_insert(const_iterator p, const_reference value);
+
+    std::expected<iterator, BufferError> try_insert(const_iterator p, value_type&& rv);
+
     bool operator==(const CircularBuffer& other) const noexcept;
 
     bool operator!=(const CircularBuffer& other) const noexcept;
 
 protected:
-    using CircularBufferBase<T, Alloc>::buff_start_;
-    using CircularBufferBase<T, Alloc>::buff_end_;
-    using CircularBufferBase<T, Alloc>::actual_start_;
-    using CircularBufferBase<T, Alloc>::actual_end_;
-    using CircularBufferBase<T, Alloc>::allocator_;
+    using CircularBufferBase<T, Alloc, Stats>::buff_start_;
+    using CircularBufferBase<T, Alloc, Stats>::buff_end_;
+    using CircularBufferBase<T, Alloc, Stats>::actual_start_;
+    using CircularBufferBase<T, Alloc, Stats>::actual_end_;
+    using CircularBufferBase<T, Alloc, Stats>::allocator_;
+    using CircularBufferBase<T, Alloc, Stats>::stats_;
+    using CircularBufferBase<T, Alloc, Stats>::trace;
+    using CircularBufferBase<T, Alloc, Stats>::owns;
+    using CircularBufferBase<T, Alloc, Stats>::advance;
+    using CircularBufferBase<T, Alloc, Stats>::open_gap;
 };
 
-template<typename T, typename Alloc>
-void CircularBuffer<T, Alloc>::push_back(const T& value) {
+template<typename T, typename Alloc, typename Stats>
+void CircularBuffer<T, Alloc, Stats>::push_back(const T& value) {
+    [[maybe_unused]] auto scope = trace(BufferOperation::push_back);
     if (capacity() == 0) {
         return;
     }
@@ -101,12 +115,15 @@ void CircularBuffer<T, Alloc>::push_back(const T& value) {
     if (next == actual_start_) {
         AllocTraits::destroy(allocator_, actual_start_);
         actual_start_ = (actual_start_ + 1 == buff_end_ ? buff_start_ : actual_start_ + 1);
+        stats_.on_overwrite();
     }
     actual_end_ = (actual_end_ + 1 == buff_end_ ? buff_start_ : actual_end_ + 1);
+    stats_.on_push(1, size());
 }
 
-template<typename T, typename Alloc>
-void CircularBuffer<T, Alloc>::push_back(T&& value) {
+template<typename T, typename Alloc, typename Stats>
+void CircularBuffer<T, Alloc, Stats>::push_back(T&& value) {
+    [[maybe_unused]] auto scope = trace(BufferOperation::push_back);
     if (capacity() == 0) {
         return;
     }
@@ -115,13 +132,16 @@ void CircularBuffer<T, Alloc>::push_back(T&& value) {
     if (next == actual_start_) {
         AllocTraits::destroy(allocator_, actual_start_);
         actual_start_ = (actual_start_ + 1 == buff_end_ ? buff_start_ : actual_start_ + 1);
+        stats_.on_overwrite();
     }
     actual_end_ = next;
+    stats_.on_push(1, size());
 }
 
-template<typename T, typename Alloc>
+template<typename T, typename Alloc, typename Stats>
 template<typename... Args>
-void CircularBuffer<T, Alloc>::emplace_back(Args&& ... args) {
+void CircularBuffer<T, Alloc, Stats>::emplace_back(Args&& ... args) {
+    [[maybe_unused]] auto scope = trace(BufferOperation::push_back);
     if (capacity() == 0) {
         return;
     }
@@ -130,12 +150,15 @@ void CircularBuffer<T, Alloc>::emplace_back(Args&& ... args) {
     if (next == actual_start_) {
         AllocTraits::destroy(allocator_, actual_start_);
         actual_start_ = (actual_start_ + 1 == buff_end_ ? buff_start_ : actual_start_ + 1);
+        stats_.on_overwrite();
     }
     actual_end_ = (actual_end_ + 1 == buff_end_ ? buff_start_ : actual_end_ + 1);
+    stats_.on_push(1, size());
 }
 
-template<typename T, typename Alloc>
-void CircularBuffer<T, Alloc>::push_front(const T& value) {
+template<typename T, typename Alloc, typename Stats>
+void CircularBuffer<T, Alloc, Stats>::push_front(const T& value) {
+    [[maybe_unused]] auto scope = trace(BufferOperation::push_front);
     if (capacity() == 0) {
         return;
     }
@@ -144,12 +167,15 @@ void CircularBuffer<T, Alloc>::push_front(const T& value) {
     if (new_start == actual_end_) {
         actual_end_ = (actual_end_ == buff_start_ ? buff_end_ - 1 : actual_end_ - 1);
         AllocTraits::destroy(allocator_, actual_end_);
+        stats_.on_overwrite();
     }
     actual_start_ = new_start;
+    stats_.on_push(1, size());
 }
 
-template<typename T, typename Alloc>
-void CircularBuffer<T, Alloc>::push_front(T&& value) {
+template<typename T, typename Alloc, typename Stats>
+void CircularBuffer<T, Alloc, Stats>::push_front(T&& value) {
+    [[maybe_unused]] auto scope = trace(BufferOperation::push_front);
     if (capacity() == 0) {
         return;
     }
@@ -158,13 +184,16 @@ void CircularBuffer<T, Alloc>::push_front(T&& value) {
     if (new_start == actual_end_) {
         actual_end_ = (actual_end_ == buff_start_ ? buff_end_ - 1 : actual_end_ - 1);
         AllocTraits::destroy(allocator_, actual_end_);
+        stats_.on_overwrite();
     }
     actual_start_ = new_start;
+    stats_.on_push(1, size());
 }
 
-template<typename T, typename Alloc>
+template<typename T, typename Alloc, typename Stats>
 template<typename... Args>
-void CircularBuffer<T, Alloc>::emplace_front(Args&& ... args) {
+void CircularBuffer<T, Alloc, Stats>::emplace_front(Args&& ... args) {
+    [[maybe_unused]] auto scope = trace(BufferOperation::push_front);
     if (capacity() == 0) {
         return;
     }
@@ -173,218 +202,147 @@ void CircularBuffer<T, Alloc>::emplace_front(Args&& ... args) {
     if (new_start == actual_end_) {
         actual_end_ = (actual_end_ == buff_start_ ? buff_end_ - 1 : actual_end_ - 1);
         AllocTraits::destroy(allocator_, actual_end_);
+        stats_.on_overwrite();
     }
     actual_start_ = new_start;
+    stats_.on_push(1, size());
 }
 
-template<typename T, typename Alloc>
-CircularBuffer<T, Alloc>::iterator
-CircularBuffer<T, Alloc>::insert(CircularBuffer<T, Alloc>::const_iterator p, const_reference value) {
-    if (std::addressof(*p) < buff_start_ || std::addressof(*p) >= buff_end_) {
-        throw std::out_of_range("Iterator is out of bounds");
-    }
+template<typename T, typename Alloc, typename Stats>
+CircularBuffer<T, Alloc, Stats>::iterator
+CircularBuffer<T, Alloc, Stats>::insert(const_iterator p, const_reference value) {
+    [[maybe_unused]] auto scope = trace(BufferOperation::insert);
+    CIRCULAR_BUFFER_CHECK(std::addressof(*p) >= buff_start_ && std::addressof(*p) < buff_end_,
+                          "Iterator is out of bounds");
     size_type index = p - begin();
-    if (index > size()) {
-        throw std::out_of_range("Iterator is out of bounds");
-    }
+    CIRCULAR_BUFFER_CHECK(index <= size(), "Iterator is out of bounds");
 
     reserve(size() + 1);
-    if (index == size()) {
-        push_back(value);
-        return --end();
-    }
-    if (index == 0) {
-        push_front(value);
-        return begin();
-    }
-
-    auto last = --end();
-    p = begin() + index;
-    AllocTraits::construct(allocator_, actual_end_, std::move_if_noexcept(*last));
-    actual_end_ = (actual_end_ + 1 == buff_end_ ? buff_start_ : actual_end_ + 1);
-    for (; last != p; --last) {
-        *last = std::move_if_noexcept(*(last - 1));
-    }
-    *p = value;
-    return p;
+    AllocTraits::construct(allocator_, open_gap(index, 1), value);
+    stats_.on_push(1, size());
+    return begin() + index;
 }
 
-template<typename T, typename Alloc>
-CircularBuffer<T, Alloc>::iterator
-CircularBuffer<T, Alloc>::insert(CircularBuffer<T, Alloc>::const_iterator p, value_type&& rv) {
-    if (std::addressof(*p) < buff_start_ || std::addressof(*p) >= buff_end_) {
-        throw std::out_of_range("Iterator is out of bounds");
-    }
+template<typename T, typename Alloc, typename Stats>
+CircularBuffer<T, Alloc, Stats>::iterator
+CircularBuffer<T, Alloc, Stats>::insert(const_iterator p, value_type&& rv) {
+    [[maybe_unused]] auto scope = trace(BufferOperation::insert);
+    CIRCULAR_BUFFER_CHECK(std::addressof(*p) >= buff_start_ && std::addressof(*p) < buff_end_,
+                          "Iterator is out of bounds");
     size_type index = p - begin();
-    if (index > size()) {
-        throw std::out_of_range("Iterator is out of bounds");
-    }
+    CIRCULAR_BUFFER_CHECK(index <= size(), "Iterator is out of bounds");
+
     reserve(size() + 1);
-    if (index == size()) {
-        push_back(std::move(rv));
-        return --end();
-    }
-    if (index == 0) {
-        push_front(std::move(rv));
-        return begin();
-    }
-    auto last = --end();
-    auto it = begin() + index;
-    AllocTraits::construct(allocator_, actual_end_, std::move_if_noexcept(*last));
-    actual_end_ = (actual_end_ + 1 == buff_end_ ? buff_start_ : actual_end_ + 1);
-    for (; last != it; --last) {
-        *last = std::move_if_noexcept(*(last - 1));
-    }
-    *it = std::move_if_noexcept(rv);
-    return it;
+    AllocTraits::construct(allocator_, open_gap(index, 1), std::move(rv));
+    stats_.on_push(1, size());
+    return begin() + index;
 }
 
-
-template<typename T, typename Alloc>
-CircularBuffer<T, Alloc>::iterator
-CircularBuffer<T, Alloc>::insert(CircularBuffer<T, Alloc>::const_iterator p, CircularBuffer<T, Alloc>::size_type n,
-                                 const_reference value) {
-    if (std::addressof(*p) < buff_start_ || std::addressof(*p) >= buff_end_) {
-        throw std::out_of_range("Iterator is out of bounds");
-    }
+template<typename T, typename Alloc, typename Stats>
+CircularBuffer<T, Alloc, Stats>::iterator
+CircularBuffer<T, Alloc, Stats>::insert(const_iterator p, size_type n, const_reference value) {
+    [[maybe_unused]] auto scope = trace(BufferOperation::insert);
+    CIRCULAR_BUFFER_CHECK(std::addressof(*p) >= buff_start_ && std::addressof(*p) < buff_end_,
+                          "Iterator is out of bounds");
     size_type index = p - begin();
     if (n == 0) {
         return begin() + index;
     }
-    if (index > size()) {
-        throw std::out_of_range("Iterator is out of bounds");
-    }
+    CIRCULAR_BUFFER_CHECK(index <= size(), "Iterator is out of bounds");
 
     reserve(size() + n);
-    if (index == size()) {
-        auto it = end();
-        for (size_type i = 0; i < n; ++i) {
-            push_back(value);
-        }
-        return it;
-    }
-    if (index == 0) {
-        for (size_type i = 0; i < n; ++i) {
-            push_front(value);
-        }
-        return begin();
+    pointer slot = open_gap(index, n);
+    for (size_type k = 0; k < n; ++k, slot = advance(slot, 1)) {
+        AllocTraits::construct(allocator_, slot, value);
     }
-
-    actual_end_ = (actual_end_ + n >= buff_end_ ? buff_start_ + ((actual_end_ + n) - buff_end_) :
-                   actual_end_ + n);
-
-    auto to_insert = begin() + index;
-    for (auto it = end() - n; it != to_insert; --it) {
-        AllocTraits::construct(allocator_, std::addressof(*(it + n - 1)), std::move_if_noexcept(*(it - 1)));
-    }
-    for (size_type i = 0; i < n; ++i) {
-        AllocTraits::construct(allocator_, std::addressof(to_insert[i]), value);
-    }
-
-    return to_insert;
+    stats_.on_push(n, size());
+    return begin() + index;
 }
 
-template<typename T, typename Alloc>
+template<typename T, typename Alloc, typename Stats>
 template<typename... Args>
-CircularBuffer<T, Alloc>::iterator
-CircularBuffer<T, Alloc>::emplace(CircularBuffer<T, Alloc>::const_iterator p, Args&& ... args) {
-    if (std::addressof(*p) < buff_start_ || std::addressof(*p) >= buff_end_) {
-        throw std::out_of_range("Iterator is out of bounds");
-    }
+CircularBuffer<T, Alloc, Stats>::iterator
+CircularBuffer<T, Alloc, Stats>::emplace(const_iterator p, Args&& ... args) {
+    [[maybe_unused]] auto scope = trace(BufferOperation::insert);
+    CIRCULAR_BUFFER_CHECK(std::addressof(*p) >= buff_start_ && std::addressof(*p) < buff_end_,
+                          "Iterator is out of bounds");
     size_type index = p - begin();
-    if (index > size()) {
-        throw std::out_of_range("Iterator is out of bounds");
-    }
+    CIRCULAR_BUFFER_CHECK(index <= size(), "Iterator is out of bounds");
+
     reserve(size() + 1);
-    if (index == size()) {
-        emplace_back(std::forward<Args>(args)...);
-        return --end();
-    }
-    if (index == 0) {
-        push_front(std::forward<Args>(args)...);
-        return begin();
-    }
-    auto last = --end();
-    auto it = begin() + index;
-    AllocTraits::construct(allocator_, actual_end_, std::move_if_noexcept(*last));
-    actual_end_ = (actual_end_ + 1 == buff_end_ ? buff_start_ : actual_end_ + 1);
-    for (; last != it; --last) {
-        *last = std::move_if_noexcept(*(last - 1));
-    }
-    *it = value_type(std::forward<Args>(args)...);
-    return it;
+    AllocTraits::construct(allocator_, open_gap(index, 1), std::forward<Args>(args)...);
+    stats_.on_push(1, size());
+    return begin() + index;
 }
 
-template<typename T, typename Alloc>
+template<typename T, typename Alloc, typename Stats>
 template<typename LegacyInputIterator>
 requires std::input_iterator<LegacyInputIterator>
-CircularBuffer<T, Alloc>::iterator
-CircularBuffer<T, Alloc>::insert(CircularBuffer<T, Alloc>::const_iterator p, LegacyInputIterator i,
-                                 LegacyInputIterator j) {
-    if (std::addressof(*p) < buff_start_ || std::addressof(*p) >= buff_end_) {
-        throw std::out_of_range("Iterator is out of bounds");
-    }
+CircularBuffer<T, Alloc, Stats>::iterator
+CircularBuffer<T, Alloc, Stats>::insert(const_iterator p, LegacyInputIterator i, LegacyInputIterator j) {
+    [[maybe_unused]] auto scope = trace(BufferOperation::insert);
+    CIRCULAR_BUFFER_CHECK(std::addressof(*p) >= buff_start_ && std::addressof(*p) < buff_end_,
+                          "Iterator is out of bounds");
     size_type index = p - begin();
     size_type n = std::distance(i, j);
     if (n == 0) {
         return begin() + index;
     }
-
-    if (index > size()) {
-        throw std::out_of_range("Iterator is out of bounds");
-    }
+    CIRCULAR_BUFFER_CHECK(index <= size(), "Iterator is out of bounds");
 
     reserve(size() + n);
-    if (index == size()) {
-        auto it = end();
-        for (; i != j; ++i) {
-            push_back(*i);
-        }
-        return it;
-    }
-    if (index == 0) {
-        for (; i != j; ++i) {
-            push_front(*i);
-        }
-        return begin();
+    pointer slot = open_gap(index, n);
+    for (; i != j; ++i, slot = advance(slot, 1)) {
+        AllocTraits::construct(allocator_, slot, *i);
     }
+    stats_.on_push(n, size());
+    return begin() + index;
+}
 
-    actual_end_ = (actual_end_ + n >= buff_end_ ? actual_end_ = buff_start_ + ((actual_end_ + n) - buff_end_) :
-                   actual_end_ + n);
+template<typename T, typename Alloc, typename Stats>
+CircularBuffer<T, Alloc, Stats>::iterator
+CircularBuffer<T, Alloc, Stats>::insert(const_iterator p, const std::initializer_list<value_type>& il) {
+    return insert(p, il.begin(), il.end());
+}
 
-    auto to_insert = begin() + index;
-    for (auto it = end() - n; it != to_insert; --it) {
-        AllocTraits::construct(allocator_, std::addressof(*(it + n - 1)), std::move_if_noexcept(*(it - 1)));
+template<typename T, typename Alloc, typename Stats>
+std::expected<typename CircularBuffer<T, Alloc, Stats>::iterator, BufferError>
+CircularBuffer<T, Alloc, Stats>::try_insert(const_iterator p, const_reference value) {
+    if (!owns(p) || static_cast<size_type>(p - cbegin()) > size()) {
+        return std::unexpected(BufferError::out_of_range);
     }
-    for (size_type k = 0; k < n; ++i, ++k) {
-        AllocTraits::construct(allocator_, std::addressof(to_insert[k]), *i);
-    }
-
-    return to_insert;
+    return insert(p, value);
 }
 
-template<typename T, typename Alloc>
-CircularBuffer<T, Alloc>::iterator
-CircularBuffer<T, Alloc>::insert(CircularBuffer<T, Alloc>::const_iterator p,
-                                 const std::initializer_list<value_type>& il) {
-    return insert(p, il.begin(), il.end());
+template<typename T, typename Alloc, typename Stats>
+std::expected<typename CircularBuffer<T, Alloc, Stats>::iterator, BufferError>
+CircularBuffer<T, Alloc, Stats>::try_insert(const_iterator p, value_type&& rv) {
+    if (!owns(p) || static_cast<size_type>(p - cbegin()) > size()) {
+        return std::unexpected(BufferError::out_of_range);
+    }
+    return insert(p, std::move(rv));
 }
 
-template<typename T, typename Alloc>
-bool CircularBuffer<T, Alloc>::operator==(const CircularBuffer& other) const noexcept {
-    return static_cast<const CircularBufferBase<T, Alloc>&>(*this).operator==(
-            static_cast<const CircularBufferBase<T, Alloc>&>(other));
+template<typename T, typename Alloc, typename Stats>
+bool CircularBuffer<T, Alloc, Stats>::operator==(const CircularBuffer& other) const noexcept {
+    return static_cast<const CircularBufferBase<T, Alloc, Stats>&>(*this).operator==(
+            static_cast<const CircularBufferBase<T, Alloc, Stats>&>(other));
 }
 
-template<typename T, typename Alloc>
-bool CircularBuffer<T, Alloc>::operator!=(const CircularBuffer& other) const noexcept {
-    return static_cast<const CircularBufferBase<T, Alloc>&>(*this).operator!=(
-            static_cast<const CircularBufferBase<T, Alloc>&>(other));
+template<typename T, typename Alloc, typename Stats>
+bool CircularBuffer<T, Alloc, Stats>::operator!=(const CircularBuffer& other) const noexcept {
+    return static_cast<const CircularBufferBase<T, Alloc, Stats>&>(*this).operator!=(
+            static_cast<const CircularBufferBase<T, Alloc, Stats>&>(other));
 }
 
-template<typename T, typename Alloc>
-void swap(CircularBuffer<T, Alloc>& lhs, CircularBuffer<T, Alloc>& rhs) {
+template<typename T, typename Alloc, typename Stats>
+void swap(CircularBuffer<T, Alloc, Stats>& lhs, CircularBuffer<T, Alloc, Stats>& rhs) {
     lhs.swap(rhs);
 }
 
-#undef USING_FIELDS
+namespace pmr {
+
+template<typename T, typename Stats = NoBufferStats>
+using CircularBuffer = ::CircularBuffer<T, std::pmr::polymorphic_allocator<T>, Stats>;
+
+} // namespace pmr
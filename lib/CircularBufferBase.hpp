@@ -1,47 +1,99 @@
 #pragma once
 
 #include "Iterator.hpp"
+#include "BufferChecks.hpp"
+#include "BufferStats.hpp"
 #include "uninitialized_copy_modified.hpp"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <optional>
+#include <span>
+
 
 #define USING_FIELDS \
-    using typename CircularBufferBase<T, Alloc>::allocator_type; \
-    using typename CircularBufferBase<T, Alloc>::AllocTraits; \
-    using typename CircularBufferBase<T, Alloc>::iterator; \
-    using typename CircularBufferBase<T, Alloc>::const_iterator; \
-    using typename CircularBufferBase<T, Alloc>::reverse_iterator; \
-    using typename CircularBufferBase<T, Alloc>::const_reverse_iterator; \
-    using typename CircularBufferBase<T, Alloc>::value_type; \
-    using typename CircularBufferBase<T, Alloc>::reference; \
-    using typename CircularBufferBase<T, Alloc>::pointer; \
-    using typename CircularBufferBase<T, Alloc>::const_reference; \
-    using typename CircularBufferBase<T, Alloc>::difference_type; \
-    using typename CircularBufferBase<T, Alloc>::size_type; \
-    using CircularBufferBase<T, Alloc>::begin; \
-    using CircularBufferBase<T, Alloc>::end; \
-    using CircularBufferBase<T, Alloc>::rbegin; \
-    using CircularBufferBase<T, Alloc>::rend; \
-    using CircularBufferBase<T, Alloc>::cbegin; \
-    using CircularBufferBase<T, Alloc>::cend; \
-    using CircularBufferBase<T, Alloc>::crbegin; \
-    using CircularBufferBase<T, Alloc>::swap; \
-    using CircularBufferBase<T, Alloc>::size; \
-    using CircularBufferBase<T, Alloc>::capacity; \
-    using CircularBufferBase<T, Alloc>::max_size; \
-    using CircularBufferBase<T, Alloc>::empty; \
-    using CircularBufferBase<T, Alloc>::reserve; \
-    using CircularBufferBase<T, Alloc>::resize; \
-    using CircularBufferBase<T, Alloc>::erase; \
-    using CircularBufferBase<T, Alloc>::clear; \
-    using CircularBufferBase<T, Alloc>::assign; \
-    using CircularBufferBase<T, Alloc>::pop_back; \
-    using CircularBufferBase<T, Alloc>::pop_front; \
-    using CircularBufferBase<T, Alloc>::front; \
-    using CircularBufferBase<T, Alloc>::back; \
-    using CircularBufferBase<T, Alloc>::get_allocator;
-
-
-template<typename T, typename Alloc = std::allocator<T>>
+    using typename CircularBufferBase<T, Alloc, Stats>::allocator_type; \
+    using typename CircularBufferBase<T, Alloc, Stats>::AllocTraits; \
+    using typename CircularBufferBase<T, Alloc, Stats>::iterator; \
+    using typename CircularBufferBase<T, Alloc, Stats>::const_iterator; \
+    using typename CircularBufferBase<T, Alloc, Stats>::reverse_iterator; \
+    using typename CircularBufferBase<T, Alloc, Stats>::const_reverse_iterator; \
+    using typename CircularBufferBase<T, Alloc, Stats>::value_type; \
+    using typename CircularBufferBase<T, Alloc, Stats>::reference; \
+    using typename CircularBufferBase<T, Alloc, Stats>::pointer; \
+    using typename CircularBufferBase<T, Alloc, Stats>::const_reference; \
+    using typename CircularBufferBase<T, Alloc, Stats>::difference_type; \
+    using typename CircularBufferBase<T, Alloc, Stats>::size_type; \
+    using CircularBufferBase<T, Alloc, Stats>::operator[]; \
+    using CircularBufferBase<T, Alloc, Stats>::begin; \
+    using CircularBufferBase<T, Alloc, Stats>::end; \
+    using CircularBufferBase<T, Alloc, Stats>::rbegin; \
+    using CircularBufferBase<T, Alloc, Stats>::rend; \
+    using CircularBufferBase<T, Alloc, Stats>::cbegin; \
+    using CircularBufferBase<T, Alloc, Stats>::cend; \
+    using CircularBufferBase<T, Alloc, Stats>::crbegin; \
+    using CircularBufferBase<T, Alloc, Stats>::swap; \
+    using CircularBufferBase<T, Alloc, Stats>::size; \
+    using CircularBufferBase<T, Alloc, Stats>::capacity; \
+    using CircularBufferBase<T, Alloc, Stats>::max_size; \
+    using CircularBufferBase<T, Alloc, Stats>::empty; \
+    using CircularBufferBase<T, Alloc, Stats>::reserve; \
+    using CircularBufferBase<T, Alloc, Stats>::shrink_to_fit; \
+    using CircularBufferBase<T, Alloc, Stats>::resize; \
+    using CircularBufferBase<T, Alloc, Stats>::erase; \
+    using CircularBufferBase<T, Alloc, Stats>::clear; \
+    using CircularBufferBase<T, Alloc, Stats>::assign; \
+    using CircularBufferBase<T, Alloc, Stats>::pop_back; \
+    using CircularBufferBase<T, Alloc, Stats>::pop_front; \
+    using CircularBufferBase<T, Alloc, Stats>::pop_back_into; \
+    using CircularBufferBase<T, Alloc, Stats>::pop_front_into; \
+    using CircularBufferBase<T, Alloc, Stats>::consume_front; \
+    using CircularBufferBase<T, Alloc, Stats>::try_front; \
+    using CircularBufferBase<T, Alloc, Stats>::try_back; \
+    using CircularBufferBase<T, Alloc, Stats>::try_pop_back; \
+    using CircularBufferBase<T, Alloc, Stats>::try_pop_front; \
+    using CircularBufferBase<T, Alloc, Stats>::try_push_back; \
+    using CircularBufferBase<T, Alloc, Stats>::try_push_front; \
+    using CircularBufferBase<T, Alloc, Stats>::try_emplace_back; \
+    using CircularBufferBase<T, Alloc, Stats>::try_erase; \
+    using CircularBufferBase<T, Alloc, Stats>::erase_if; \
+    using CircularBufferBase<T, Alloc, Stats>::retain; \
+    using CircularBufferBase<T, Alloc, Stats>::front; \
+    using CircularBufferBase<T, Alloc, Stats>::back; \
+    using CircularBufferBase<T, Alloc, Stats>::prepare; \
+    using CircularBufferBase<T, Alloc, Stats>::commit; \
+    using CircularBufferBase<T, Alloc, Stats>::peek; \
+    using CircularBufferBase<T, Alloc, Stats>::consume; \
+    using CircularBufferBase<T, Alloc, Stats>::save; \
+    using CircularBufferBase<T, Alloc, Stats>::load; \
+    using CircularBufferBase<T, Alloc, Stats>::stats; \
+    using CircularBufferBase<T, Alloc, Stats>::get_allocator;
+
+
+// Up to two contiguous pieces of the ring, in logical order: `second` is non-empty only when the region wraps.
+template<typename T>
+struct RingRegions {
+    std::span<T> first;
+    std::span<T> second;
+
+    std::size_t size() const noexcept {
+        return first.size() + second.size();
+    }
+};
+
+struct CircularBufferSnapshotHeader {
+    static constexpr std::uint64_t kMagic = 0x50414e5342554643; // "CFUBSNAP"
+
+    std::uint64_t magic;
+    std::uint64_t element_size;
+    std::uint64_t capacity;
+    std::uint64_t size;
+};
+
+
+template<typename T, typename Alloc = std::allocator<T>, typename Stats = NoBufferStats>
 class CircularBufferBase {
 public:
     using allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<T>;
@@ -98,6 +150,7 @@ public:
 
     void clear() noexcept;
 
+    // The assign overloads and copy assignment reuse the current block when it is large enough.
     void assign(size_type n, const_reference value);
 
     template<typename LegacyInputIterator>
@@ -114,6 +167,53 @@ public:
 
     value_type pop_front();
 
+    // Move-assign the element into out instead of returning it; false on an empty buffer.
+    bool pop_back_into(reference out);
+
+    bool pop_front_into(reference out);
+
+    // Calls f(front()) in place, then destroys the element; false on an empty buffer.
+    // If f throws, the element stays in the buffer.
+    template<typename F>
+    bool consume_front(F&& f);
+
+    // Non-throwing counterparts of front()/back(): nullptr on an empty buffer.
+    pointer try_front() noexcept;
+
+    const T* try_front() const noexcept;
+
+    pointer try_back() noexcept;
+
+    const T* try_back() const noexcept;
+
+    std::optional<value_type> try_pop_back();
+
+    std::optional<value_type> try_pop_front();
+
+    // Never overwrite and never reallocate: false when there is no free slot.
+    bool try_push_back(const_reference value);
+
+    bool try_push_back(value_type&& value);
+
+    bool try_push_front(const_reference value);
+
+    bool try_push_front(value_type&& value);
+
+    template<typename... Args>
+    bool try_emplace_back(Args&& ... args);
+
+    std::expected<iterator, BufferError> try_erase(const_iterator q);
+
+    std::expected<iterator, BufferError> try_erase(const_iterator q1, const_iterator q2);
+
+    // Removes every element matching pred in one pass, keeping the order of the rest; returns the removed count.
+    template<typename Predicate>
+    size_type erase_if(Predicate pred);
+
+    // Keeps only the elements matching pred; returns the removed count.
+    template<typename Predicate>
+    size_type retain(Predicate pred);
+
     size_type size() const noexcept;
 
     size_type capacity() const noexcept;
@@ -132,10 +232,46 @@ public:
 
     void reserve(size_type n);
 
+    // Reallocates to exactly size() slots; reassignment and copies otherwise keep the capacity.
+    void shrink_to_fit();
+
     void resize(size_type n, const value_type& value = value_type());
 
+    // Free slots after the last element. They hold no objects: construct into them, then commit().
+    RingRegions<T> prepare(size_type n);
+
+    void commit(size_type n);
+
+    RingRegions<T> peek(size_type n);
+
+    RingRegions<const T> peek(size_type n) const;
+
+    // Destroys n elements from the front.
+    void consume(size_type n);
+
+    // Snapshot as a header plus the stored segments in bulk. Writer is called as writer(std::span<const std::byte>).
+    template<typename Writer>
+    requires std::is_trivially_copyable_v<T>
+    void save(Writer&& writer) const;
+
+    // Same header, then element_writer(writer, element) for every element.
+    template<typename Writer, typename ElementWriter>
+    void save(Writer&& writer, ElementWriter&& element_writer) const;
+
+    // Replaces the contents with a snapshot, allocating once at the saved capacity.
+    // Reader is called as reader(std::span<std::byte>) and must fill the whole span.
+    template<typename Reader>
+    requires std::is_trivially_copyable_v<T>
+    void load(Reader&& reader);
+
+    // element_reader(reader) must return the next value_type.
+    template<typename Reader, typename ElementReader>
+    void load(Reader&& reader, ElementReader&& element_reader);
+
     allocator_type get_allocator() const noexcept;
 
+    const Stats& stats() const noexcept;
+
 protected:
     explicit CircularBufferBase(const Alloc& allocator = Alloc());
 
@@ -155,38 +291,88 @@ protected:
 
     CircularBufferBase& operator=(const CircularBufferBase& other) noexcept;
 
-    CircularBufferBase& operator=(CircularBufferBase&& other) noexcept;
+    CircularBufferBase& operator=(CircularBufferBase&& other) noexcept(
+            AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value);
 
     CircularBufferBase& operator=(const std::initializer_list<value_type>& list);
 
+    pointer advance(pointer p, size_type n) const noexcept;
+
+    template<typename U>
+    RingRegions<U> regions_from(pointer p, size_type n) const noexcept;
+
+    template<typename Writer>
+    void save_header(Writer& writer) const;
+
+    template<typename Reader>
+    static CircularBufferSnapshotHeader load_header(Reader& reader);
+
+    // Takes over other's block without touching the allocators; other is left without storage.
+    void steal(CircularBufferBase& other) noexcept;
+
+    void adopt(pointer new_buff_start, size_type new_capacity, size_type new_size, size_type moved = 0) noexcept;
+
+    void record_footprint() noexcept;
+
+    // Replaces the contents with n values taken from next(). Storage is reused when n fits: live slots are
+    // assigned, the rest constructed or destroyed. Otherwise a block of fresh_capacity >= n slots is allocated.
+    template<typename Next>
+    void assign_from(Next&& next, size_type n, size_type fresh_capacity);
+
+    void copy_from(const CircularBufferBase& other);
+
+    bool is_full() const noexcept;
+
+    bool owns(const_iterator q) const noexcept;
+
+    // Makes n uninitialized slots before logical position index by shifting the shorter side; returns the first one.
+    // The caller must have reserved room for n more elements.
+    pointer open_gap(size_type index, size_type n);
+
+    // Destroys the elements at logical positions [index, index + n) and closes the hole from the shorter side.
+    void close_gap(size_type index, size_type n);
+
+    // memmove of n slots from src to dst split at the wrap point; forward when dst precedes src in ring order.
+    void ring_move(pointer dst, pointer src, size_type n, bool forward) noexcept;
+
+    // RAII scope from Stats::scope(operation) if the policy traces operations, an empty object otherwise.
+    auto trace(BufferOperation operation) noexcept;
+
+    // Declared first: the constructors allocate through it while initializing the pointers.
+    [[no_unique_address]] allocator_type allocator_;
+
     pointer buff_start_;
     pointer buff_end_;
     pointer actual_start_;
     pointer actual_end_;
 
-    [[no_unique_address]] allocator_type allocator_;
+    [[no_unique_address]] Stats stats_;
 };
 
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::CircularBufferBase(const Alloc& allocator)
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::CircularBufferBase(const Alloc& allocator)
         : allocator_(allocator),
           buff_start_(AllocTraits::allocate(allocator_, 1)),
           buff_end_(buff_start_ + 1),
           actual_start_(buff_start_),
-          actual_end_(buff_start_) {}
+          actual_end_(buff_start_) {
+    record_footprint();
+}
 
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::CircularBufferBase(size_type size, const Alloc& allocator)
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::CircularBufferBase(size_type size, const Alloc& allocator)
         : allocator_(allocator),
           buff_start_(AllocTraits::allocate(allocator_, size + 1)),
           buff_end_(buff_start_ + size + 1),
           actual_start_(buff_start_),
-          actual_end_(buff_start_) {}
+          actual_end_(buff_start_) {
+    record_footprint();
+}
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::CircularBufferBase(size_type size, const_reference value, const Alloc& allocator)
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::CircularBufferBase(size_type size, const_reference value, const Alloc& allocator)
         : allocator_(allocator),
           buff_start_(AllocTraits::allocate(allocator_, size + 1)),
           buff_end_(buff_start_ + size + 1),
@@ -204,13 +390,14 @@ CircularBufferBase<T, Alloc>::CircularBufferBase(size_type size, const_reference
         AllocTraits::deallocate(allocator_, buff_start_, size + 1);
         throw;
     }
+    record_footprint();
 }
 
 
-template<typename T, typename Alloc>
+template<typename T, typename Alloc, typename Stats>
 template<typename LegacyInputIterator>
 requires std::input_iterator<LegacyInputIterator>
-CircularBufferBase<T, Alloc>::CircularBufferBase(LegacyInputIterator i, LegacyInputIterator j,
+CircularBufferBase<T, Alloc, Stats>::CircularBufferBase(LegacyInputIterator i, LegacyInputIterator j,
                                                  const Alloc& allocator)
         : allocator_(allocator),
           buff_start_(AllocTraits::allocate(allocator_, std::distance(i, j) + 1)),
@@ -223,10 +410,11 @@ CircularBufferBase<T, Alloc>::CircularBufferBase(LegacyInputIterator i, LegacyIn
         AllocTraits::deallocate(allocator_, buff_start_, std::distance(buff_start_, buff_end_));
         throw;
     }
+    record_footprint();
 }
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::CircularBufferBase(const std::initializer_list<value_type>& list,
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::CircularBufferBase(const std::initializer_list<value_type>& list,
                                                  const Alloc& allocator)
         : allocator_(allocator),
           buff_start_(AllocTraits::allocate(allocator_, list.size() + 1)),
@@ -239,14 +427,15 @@ CircularBufferBase<T, Alloc>::CircularBufferBase(const std::initializer_list<val
         AllocTraits::deallocate(allocator_, buff_start_, list.size() + 1);
         throw;
     }
+    record_footprint();
 }
 
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::CircularBufferBase(const CircularBufferBase& other)
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::CircularBufferBase(const CircularBufferBase& other)
         : allocator_(AllocTraits::select_on_container_copy_construction(other.allocator_)),
-          buff_start_(AllocTraits::allocate(allocator_, other.size() + 1)),
-          buff_end_(buff_start_ + other.size() + 1),
+          buff_start_(AllocTraits::allocate(allocator_, (other.buff_start_ == nullptr ? 0 : other.capacity()) + 1)),
+          buff_end_(buff_start_ + (other.buff_start_ == nullptr ? 0 : other.capacity()) + 1),
           actual_start_(buff_start_),
           actual_end_(actual_start_ + other.size()) {
     try {
@@ -255,67 +444,62 @@ CircularBufferBase<T, Alloc>::CircularBufferBase(const CircularBufferBase& other
         AllocTraits::deallocate(allocator_, buff_start_, capacity() + 1);
         throw;
     }
+    record_footprint();
 }
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::CircularBufferBase(CircularBufferBase&& other) noexcept
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::CircularBufferBase(CircularBufferBase&& other) noexcept
         : allocator_(std::move(other.allocator_)),
           buff_start_(other.buff_start_),
           buff_end_(other.buff_end_),
           actual_start_(other.actual_start_),
           actual_end_(other.actual_end_) {
     other.buff_start_ = other.buff_end_ = other.actual_start_ = other.actual_end_ = nullptr;
+    record_footprint();
 }
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>& CircularBufferBase<T, Alloc>::operator=(const CircularBufferBase& other) noexcept {
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>& CircularBufferBase<T, Alloc, Stats>::operator=(const CircularBufferBase& other) noexcept {
     if (this == &other) {
         return *this;
     }
     if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
-        allocator_type new_allocator = other;
-
-        auto new_buff_start = AllocTraits::allocate(new_allocator, other.size() + 1);
-        try {
-            my_uninitialized_copy(other.begin(), other.end(), new_buff_start, new_allocator);
-        } catch (...) {
-            AllocTraits::deallocate(new_allocator, new_buff_start, other.size() + 1);
-            throw;
-        }
-
-        clear();
-        AllocTraits::deallocate(allocator_, buff_start_, capacity() + 1);
+        if (allocator_ != other.allocator_) {
+            // The old block has to go back to the old allocator, so nothing can be reused.
+            allocator_type new_allocator = other.allocator_;
+            const size_type new_capacity = other.capacity();
+
+            auto new_buff_start = AllocTraits::allocate(new_allocator, new_capacity + 1);
+            try {
+                my_uninitialized_copy(other.begin(), other.end(), new_buff_start, new_allocator);
+            } catch (...) {
+                AllocTraits::deallocate(new_allocator, new_buff_start, new_capacity + 1);
+                throw;
+            }
 
-        allocator_ = std::move(new_allocator);
-        buff_start_ = new_buff_start;
-        buff_end_ = new_buff_start + other.size() + 1;
-        actual_start_ = buff_start_;
-        actual_end_ = buff_end_ - 1;
+            clear();
+            AllocTraits::deallocate(allocator_, buff_start_, capacity() + 1);
 
-        return *this;
-    }
+            stats_.on_reallocate(capacity(), new_capacity, 0);
+            allocator_ = std::move(new_allocator);
+            buff_start_ = new_buff_start;
+            buff_end_ = new_buff_start + new_capacity + 1;
+            actual_start_ = buff_start_;
+            actual_end_ = buff_start_ + other.size();
+            record_footprint();
 
-    pointer new_buff_start = AllocTraits::allocate(allocator_, other.size() + 1);
-    try {
-        my_uninitialized_copy(other.begin(), other.end(), new_buff_start, allocator_);
-    } catch (...) {
-        AllocTraits::deallocate(allocator_, new_buff_start, other.size() + 1);
-        throw;
+            return *this;
+        }
+        allocator_ = other.allocator_;
     }
-
-    clear();
-    AllocTraits::deallocate(allocator_, buff_start_, std::distance(buff_start_, buff_end_));
-
-    buff_start_ = new_buff_start;
-    buff_end_ = new_buff_start + other.size() + 1;
-    actual_start_ = buff_start_;
-    actual_end_ = buff_end_ - 1;
+    copy_from(other);
 
     return *this;
 }
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>& CircularBufferBase<T, Alloc>::operator=(CircularBufferBase&& other) noexcept {
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>& CircularBufferBase<T, Alloc, Stats>::operator=(CircularBufferBase&& other) noexcept(
+        AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value) {
     if (this == &other) {
         return *this;
     }
@@ -323,171 +507,185 @@ CircularBufferBase<T, Alloc>& CircularBufferBase<T, Alloc>::operator=(CircularBu
         clear();
         AllocTraits::deallocate(allocator_, buff_start_, std::distance(buff_start_, buff_end_));
         allocator_ = std::move(other.allocator_);
-        buff_start_ = other.buff_start_;
-        buff_end_ = other.buff_end_;
-        actual_start_ = other.actual_start_;
-        actual_end_ = other.actual_end_;
-
-        other.buff_start_ = other.buff_end_ = other.actual_start_ = other.actual_end_ = nullptr;
-        return *this;
-    }
-
-    pointer new_buff_start = AllocTraits::allocate(allocator_, other.capacity() + 1);
-    try {
-        my_uninitialized_move(other.begin(), other.end(), new_buff_start, allocator_);
-    } catch (...) {
-        AllocTraits::deallocate(allocator_, new_buff_start, other.capacity() + 1);
-        throw;
+        steal(other);
+    } else if (allocator_ == other.allocator_) {
+        clear();
+        AllocTraits::deallocate(allocator_, buff_start_, std::distance(buff_start_, buff_end_));
+        steal(other);
+    } else {
+        pointer new_buff_start = AllocTraits::allocate(allocator_, other.capacity() + 1);
+        try {
+            my_uninitialized_move(other.begin(), other.end(), new_buff_start, allocator_);
+        } catch (...) {
+            AllocTraits::deallocate(allocator_, new_buff_start, other.capacity() + 1);
+            throw;
+        }
+        adopt(new_buff_start, other.capacity(), other.size(), other.size());
     }
 
-    clear();
-    AllocTraits::deallocate(allocator_, buff_start_, std::distance(buff_start_, buff_end_));
-    buff_start_ = new_buff_start;
-    buff_end_ = new_buff_start + other.capacity() + 1;
-    actual_start_ = buff_start_;
-    actual_end_ = actual_start_ + other.size();
-
     return *this;
 }
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>&
-CircularBufferBase<T, Alloc>::operator=(const std::initializer_list<value_type>& list) {
-    pointer new_arr = AllocTraits::allocate(allocator_, list.size() + 1);
-
-    try {
-        my_uninitialized_copy(list.begin(), list.end(), new_arr, allocator_);
-    } catch (...) {
-        AllocTraits::deallocate(allocator_, new_arr, list.size() + 1);
-        throw;
-    }
-
-    clear();
-    AllocTraits::deallocate(allocator_, buff_start_, capacity() + 1);
-
-    buff_start_ = new_arr;
-    buff_end_ = buff_start_ + list.size() + 1;
-    actual_start_ = buff_start_;
-    actual_end_ = buff_end_ - 1;
-
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>&
+CircularBufferBase<T, Alloc, Stats>::operator=(const std::initializer_list<value_type>& list) {
+    assign(list);
     return *this;
 }
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::value_type CircularBufferBase<T, Alloc>::pop_back() {
-    if (empty()) {
-        throw std::out_of_range("Trying to pop_back() from an empty buffer");
-    }
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::value_type CircularBufferBase<T, Alloc, Stats>::pop_back() {
+    [[maybe_unused]] auto scope = trace(BufferOperation::pop_back);
+    CIRCULAR_BUFFER_CHECK(!empty(), "Trying to pop_back() from an empty buffer");
     actual_end_ = (actual_end_ == buff_start_ ? buff_end_ - 1 : actual_end_ - 1);
     auto to_return = std::move(*actual_end_);
     AllocTraits::destroy(allocator_, actual_end_);
+    stats_.on_pop(1);
     return to_return;
 }
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::value_type CircularBufferBase<T, Alloc>::pop_front() {
-    if (empty()) {
-        throw std::out_of_range("Trying to pop_back() from an empty buffer");
-    }
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::value_type CircularBufferBase<T, Alloc, Stats>::pop_front() {
+    [[maybe_unused]] auto scope = trace(BufferOperation::pop_front);
+    CIRCULAR_BUFFER_CHECK(!empty(), "Trying to pop_back() from an empty buffer");
     auto to_return = std::move(*actual_start_);
     AllocTraits::destroy(allocator_, actual_start_);
     actual_start_ = (actual_start_ + 1 == buff_end_ ? buff_start_ : actual_start_ + 1);
+    stats_.on_pop(1);
 
     return to_return;
 }
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::size_type CircularBufferBase<T, Alloc>::size() const noexcept {
-    return std::distance(cbegin(), cend());
+template<typename T, typename Alloc, typename Stats>
+bool CircularBufferBase<T, Alloc, Stats>::pop_back_into(reference out) {
+    [[maybe_unused]] auto scope = trace(BufferOperation::pop_back);
+    if (actual_start_ == actual_end_) {
+        return false;
+    }
+    auto last = (actual_end_ == buff_start_ ? buff_end_ - 1 : actual_end_ - 1);
+    out = std::move(*last);
+    AllocTraits::destroy(allocator_, last);
+    actual_end_ = last;
+    stats_.on_pop(1);
+    return true;
 }
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::size_type CircularBufferBase<T, Alloc>::capacity() const noexcept {
+template<typename T, typename Alloc, typename Stats>
+bool CircularBufferBase<T, Alloc, Stats>::pop_front_into(reference out) {
+    return consume_front([&out](reference value) {
+        out = std::move(value);
+    });
+}
+
+template<typename T, typename Alloc, typename Stats>
+template<typename F>
+bool CircularBufferBase<T, Alloc, Stats>::consume_front(F&& f) {
+    [[maybe_unused]] auto scope = trace(BufferOperation::pop_front);
+    if (actual_start_ == actual_end_) {
+        return false;
+    }
+    std::forward<F>(f)(*actual_start_);
+    AllocTraits::destroy(allocator_, actual_start_);
+    actual_start_ = (actual_start_ + 1 == buff_end_ ? buff_start_ : actual_start_ + 1);
+    stats_.on_pop(1);
+    return true;
+}
+
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::size_type CircularBufferBase<T, Alloc, Stats>::size() const noexcept {
+    if (actual_end_ >= actual_start_) {
+        return std::distance(actual_start_, actual_end_);
+    }
+    return std::distance(actual_start_, buff_end_) + std::distance(buff_start_, actual_end_);
+}
+
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::size_type CircularBufferBase<T, Alloc, Stats>::capacity() const noexcept {
     return std::distance(buff_start_, buff_end_) - 1;
 }
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::reference CircularBufferBase<T, Alloc>::operator[](size_type i) {
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::reference CircularBufferBase<T, Alloc, Stats>::operator[](size_type i) {
     return *(begin() + i);
 }
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::const_reference CircularBufferBase<T, Alloc>::operator[](size_type i) const {
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::const_reference CircularBufferBase<T, Alloc, Stats>::operator[](size_type i) const {
     return *(cbegin() + i);
 }
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::iterator CircularBufferBase<T, Alloc>::begin() noexcept {
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::iterator CircularBufferBase<T, Alloc, Stats>::begin() noexcept {
     return CircularBufferBase::iterator(actual_start_, buff_start_, buff_end_, actual_start_, actual_end_);
 }
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::iterator CircularBufferBase<T, Alloc>::end() noexcept {
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::iterator CircularBufferBase<T, Alloc, Stats>::end() noexcept {
     return CircularBufferBase::iterator(actual_end_, buff_start_, buff_end_, actual_start_, actual_end_);
 }
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::const_iterator CircularBufferBase<T, Alloc>::begin() const noexcept {
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::const_iterator CircularBufferBase<T, Alloc, Stats>::begin() const noexcept {
     return CircularBufferBase::const_iterator(actual_start_, buff_start_, buff_end_, actual_start_, actual_end_);
 }
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::const_iterator CircularBufferBase<T, Alloc>::end() const noexcept {
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::const_iterator CircularBufferBase<T, Alloc, Stats>::end() const noexcept {
     return CircularBufferBase::const_iterator(actual_end_, buff_start_, buff_end_, actual_start_, actual_end_);
 }
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::const_iterator CircularBufferBase<T, Alloc>::cbegin() const noexcept {
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::const_iterator CircularBufferBase<T, Alloc, Stats>::cbegin() const noexcept {
     return CircularBufferBase::const_iterator(actual_start_, buff_start_, buff_end_, actual_start_, actual_end_);
 }
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::const_iterator CircularBufferBase<T, Alloc>::cend() const noexcept {
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::const_iterator CircularBufferBase<T, Alloc, Stats>::cend() const noexcept {
     return CircularBufferBase::const_iterator(actual_end_, buff_start_, buff_end_, actual_start_, actual_end_);
 }
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::reverse_iterator CircularBufferBase<T, Alloc>::rbegin() noexcept {
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::reverse_iterator CircularBufferBase<T, Alloc, Stats>::rbegin() noexcept {
     return reverse_iterator(iterator(actual_end_, buff_start_, buff_end_, actual_start_, actual_end_));
 }
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::reverse_iterator CircularBufferBase<T, Alloc>::rend() noexcept {
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::reverse_iterator CircularBufferBase<T, Alloc, Stats>::rend() noexcept {
     return reverse_iterator(iterator(actual_start_, buff_start_, buff_end_, actual_start_, actual_end_));
 }
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::const_reverse_iterator CircularBufferBase<T, Alloc>::rbegin() const noexcept {
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::const_reverse_iterator CircularBufferBase<T, Alloc, Stats>::rbegin() const noexcept {
     return const_reverse_iterator(iterator(actual_end_, buff_start_, buff_end_, actual_start_, actual_end_));
 }
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::const_reverse_iterator CircularBufferBase<T, Alloc>::rend() const noexcept {
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::const_reverse_iterator CircularBufferBase<T, Alloc, Stats>::rend() const noexcept {
     return const_reverse_iterator(iterator(actual_start_, buff_start_, buff_end_, actual_start_, actual_end_));
 }
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::const_reverse_iterator CircularBufferBase<T, Alloc>::crbegin() const noexcept {
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::const_reverse_iterator CircularBufferBase<T, Alloc, Stats>::crbegin() const noexcept {
     return const_reverse_iterator(const_iterator(actual_end_, buff_start_, buff_end_, actual_start_, actual_end_));
 }
 
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::const_reverse_iterator CircularBufferBase<T, Alloc>::crend() const noexcept {
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::const_reverse_iterator CircularBufferBase<T, Alloc, Stats>::crend() const noexcept {
     return const_reverse_iterator(const_iterator(actual_start_, buff_start_, buff_end_, actual_start_, actual_end_));
 }
 
 
-template<typename T, typename Alloc>
-bool CircularBufferBase<T, Alloc>::operator==(const CircularBufferBase& other) const noexcept {
+template<typename T, typename Alloc, typename Stats>
+bool CircularBufferBase<T, Alloc, Stats>::operator==(const CircularBufferBase& other) const noexcept {
     if (this == &other) {
         return true;
     }
     return std::equal(cbegin(), cend(), other.cbegin(), other.cend());
 }
 
-template<typename T, typename Alloc>
-void CircularBufferBase<T, Alloc>::swap(CircularBufferBase& other) {
+template<typename T, typename Alloc, typename Stats>
+void CircularBufferBase<T, Alloc, Stats>::swap(CircularBufferBase& other) {
     if (this == &other) {
         return;
     }
@@ -499,6 +697,15 @@ void CircularBufferBase<T, Alloc>::swap(CircularBufferBase& other) {
         std::swap(actual_end_, other.actual_end_);
         return;
     }
+    if (allocator_ == other.allocator_) {
+        std::swap(buff_start_, other.buff_start_);
+        std::swap(buff_end_, other.buff_end_);
+        std::swap(actual_start_, other.actual_start_);
+        std::swap(actual_end_, other.actual_end_);
+        record_footprint();
+        other.record_footprint();
+        return;
+    }
     const size_type this_old_size = this->size();
     const size_type this_old_capacity = this->capacity();
     const size_type other_old_size = other.size();
@@ -507,7 +714,7 @@ void CircularBufferBase<T, Alloc>::swap(CircularBufferBase& other) {
     pointer new_this_buff_start = AllocTraits::allocate(allocator_, other_old_capacity + 1);
     pointer new_other_buff_start;
     try {
-        new_other_buff_start = AllocTraits::allocate(other.allocator_, this_old_size + 1);
+        new_other_buff_start = AllocTraits::allocate(other.allocator_, this_old_capacity + 1);
     } catch (...) {
         AllocTraits::deallocate(allocator_, new_this_buff_start, other_old_capacity + 1);
         throw;
@@ -540,46 +747,78 @@ void CircularBufferBase<T, Alloc>::swap(CircularBufferBase& other) {
 
 }
 
-template<typename T, typename Alloc>
-bool CircularBufferBase<T, Alloc>::operator!=(const CircularBufferBase& other) const noexcept {
+template<typename T, typename Alloc, typename Stats>
+bool CircularBufferBase<T, Alloc, Stats>::operator!=(const CircularBufferBase& other) const noexcept {
     return !this->operator==(other);
 }
 
-template<typename T, typename Alloc>
-bool CircularBufferBase<T, Alloc>::empty() const noexcept {
-    return size() == 0;
+template<typename T, typename Alloc, typename Stats>
+bool CircularBufferBase<T, Alloc, Stats>::empty() const noexcept {
+    return actual_start_ == actual_end_;
 }
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::size_type CircularBufferBase<T, Alloc>::max_size() const noexcept {
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::size_type CircularBufferBase<T, Alloc, Stats>::max_size() const noexcept {
     return std::min(AllocTraits::max_size(*this),
                     std::numeric_limits<std::ranges::__detail::__max_size_type>::max() / sizeof(size_type));
 }
 
-template<typename T, typename Alloc>
-void CircularBufferBase<T, Alloc>::reserve(CircularBufferBase<T, Alloc>::size_type n) {
+template<typename T, typename Alloc, typename Stats>
+void CircularBufferBase<T, Alloc, Stats>::reserve(CircularBufferBase<T, Alloc, Stats>::size_type n) {
+    [[maybe_unused]] auto scope = trace(BufferOperation::reserve);
     if (capacity() >= n) {
         return;
     }
     auto new_buff_start = AllocTraits::allocate(allocator_, n + 1);
-    try {
-        my_uninitialized_move(begin(), end(), new_buff_start, allocator_);
-    } catch (...) {
-        AllocTraits::deallocate(allocator_, new_buff_start, n + 1);
-        throw;
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        const auto regions = peek(size());
+        if (!regions.first.empty()) {
+            std::memcpy(static_cast<void*>(new_buff_start), regions.first.data(), regions.first.size_bytes());
+        }
+        if (!regions.second.empty()) {
+            std::memcpy(static_cast<void*>(new_buff_start + regions.first.size()), regions.second.data(),
+                        regions.second.size_bytes());
+        }
+    } else {
+        try {
+            my_uninitialized_move(begin(), end(), new_buff_start, allocator_);
+        } catch (...) {
+            AllocTraits::deallocate(allocator_, new_buff_start, n + 1);
+            throw;
+        }
     }
-    auto old_size = size();
-    clear();
-    AllocTraits::deallocate(allocator_, buff_start_, capacity() + 1);
+    adopt(new_buff_start, n, size(), size());
+}
 
-    buff_start_ = new_buff_start;
-    buff_end_ = buff_start_ + n + 1;
-    actual_start_ = buff_start_;
-    actual_end_ = actual_start_ + old_size;
+template<typename T, typename Alloc, typename Stats>
+void CircularBufferBase<T, Alloc, Stats>::shrink_to_fit() {
+    if (capacity() == size()) {
+        return;
+    }
+    const size_type n = size();
+    auto new_buff_start = AllocTraits::allocate(allocator_, n + 1);
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        const auto regions = peek(n);
+        if (!regions.first.empty()) {
+            std::memcpy(static_cast<void*>(new_buff_start), regions.first.data(), regions.first.size_bytes());
+        }
+        if (!regions.second.empty()) {
+            std::memcpy(static_cast<void*>(new_buff_start + regions.first.size()), regions.second.data(),
+                        regions.second.size_bytes());
+        }
+    } else {
+        try {
+            my_uninitialized_move(begin(), end(), new_buff_start, allocator_);
+        } catch (...) {
+            AllocTraits::deallocate(allocator_, new_buff_start, n + 1);
+            throw;
+        }
+    }
+    adopt(new_buff_start, n, n, n);
 }
 
-template<typename T, typename Alloc>
-void CircularBufferBase<T, Alloc>::resize(size_type n, const value_type& value) {
+template<typename T, typename Alloc, typename Stats>
+void CircularBufferBase<T, Alloc, Stats>::resize(size_type n, const value_type& value) {
     if (n == size()) {
         return;
     }
@@ -610,51 +849,38 @@ void CircularBufferBase<T, Alloc>::resize(size_type n, const value_type& value)
     }
 }
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::iterator CircularBufferBase<T, Alloc>::erase(CircularBufferBase::const_iterator q) {
-    if (std::addressof(*q) < buff_start_ || std::addressof(*q) >= buff_end_) {
-        throw std::out_of_range("Iterator is out of bounds");
-    }
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::iterator CircularBufferBase<T, Alloc, Stats>::erase(CircularBufferBase::const_iterator q) {
+    [[maybe_unused]] auto scope = trace(BufferOperation::erase);
+    CIRCULAR_BUFFER_CHECK(std::addressof(*q) >= buff_start_ && std::addressof(*q) < buff_end_,
+                          "Iterator is out of bounds");
     size_type index = q - cbegin();
-    if (index >= size()) {
-        throw std::out_of_range("Iterator is out of bounds");
-    }
-    for (auto it = begin() + index; index < size() - 1; ++index, ++it) {
-        *it = std::move_if_noexcept(*(it + 1));
-    }
-    actual_end_ = (actual_end_ == buff_start_ ? buff_end_ - 1 : actual_end_ - 1);
-    AllocTraits::destroy(allocator_, actual_end_);
+    CIRCULAR_BUFFER_CHECK(index < size(), "Iterator is out of bounds");
+    close_gap(index, 1);
+    stats_.on_pop(1);
 
     return begin() + index;
 }
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::iterator CircularBufferBase<T, Alloc>::erase(CircularBufferBase::const_iterator q1,
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::iterator CircularBufferBase<T, Alloc, Stats>::erase(CircularBufferBase::const_iterator q1,
                                                                            CircularBufferBase::const_iterator q2) {
-    if (std::addressof(*q1) < buff_start_ || std::addressof(*q1) >= buff_end_ ||
-        std::addressof(*q2) < buff_start_ || std::addressof(*q2) >= buff_end_) {
-        throw std::out_of_range("Iterator is out of bounds");
-    }
+    [[maybe_unused]] auto scope = trace(BufferOperation::erase);
+    CIRCULAR_BUFFER_CHECK(std::addressof(*q1) >= buff_start_ && std::addressof(*q1) < buff_end_ &&
+                          std::addressof(*q2) >= buff_start_ && std::addressof(*q2) < buff_end_,
+                          "Iterator is out of bounds");
     const size_type index_start = q1 - cbegin();
     const size_type index_end = (q2 - cbegin()) - 1;
     const size_type number_of_elements = index_end - index_start + 1;
-    if (index_start >= size() || index_end >= size()) {
-        throw std::out_of_range("Iterator is out of bounds");
-    }
-
-    for (auto it = q1; it != q2; ++it) {
-        AllocTraits::destroy(allocator_, std::addressof(*it));
-    }
-    for (auto it = begin() + index_end + 1; it != end(); ++it) {
-        *(it - number_of_elements) = std::move_if_noexcept(*it);
-    }
+    CIRCULAR_BUFFER_CHECK(index_start < size() && index_end < size(), "Iterator is out of bounds");
 
-    actual_end_ = std::addressof(*(end() - number_of_elements));
+    close_gap(index_start, number_of_elements);
+    stats_.on_pop(number_of_elements);
     return begin() + index_start;
 }
 
-template<typename T, typename Alloc>
-void CircularBufferBase<T, Alloc>::clear() noexcept {
+template<typename T, typename Alloc, typename Stats>
+void CircularBufferBase<T, Alloc, Stats>::clear() noexcept {
     for (auto it = cbegin(); it != cend(); ++it) {
         AllocTraits::destroy(allocator_, std::addressof(*it));
     }
@@ -662,84 +888,581 @@ void CircularBufferBase<T, Alloc>::clear() noexcept {
     actual_end_ = buff_start_;
 }
 
-template<typename T, typename Alloc>
-void CircularBufferBase<T, Alloc>::assign(CircularBufferBase::size_type n, const_reference value) {
-    pointer new_arr = AllocTraits::allocate(allocator_, n + 1);
-    try {
-        my_uninitialized_copy(n, value, new_arr, allocator_);
-    } catch (...) {
-        AllocTraits::deallocate(allocator_, new_arr, n + 1);
-        throw;
+template<typename T, typename Alloc, typename Stats>
+void CircularBufferBase<T, Alloc, Stats>::assign(CircularBufferBase::size_type n, const_reference value) {
+    assign_from([&value]() -> const_reference { return value; }, n, n);
+}
+
+template<typename T, typename Alloc, typename Stats>
+template<typename LegacyInputIterator>
+requires std::input_iterator<LegacyInputIterator>
+void CircularBufferBase<T, Alloc, Stats>::assign(LegacyInputIterator i, LegacyInputIterator j) {
+    const size_type new_size = std::distance(i, j);
+    assign_from([&i]() -> decltype(auto) { return *i++; }, new_size, new_size);
+}
+
+template<typename T, typename Alloc, typename Stats>
+void CircularBufferBase<T, Alloc, Stats>::assign(const std::initializer_list<value_type>& il) {
+    assign(il.begin(), il.end());
+}
+
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::reference CircularBufferBase<T, Alloc, Stats>::front() {
+    CIRCULAR_BUFFER_CHECK(!empty(), "Trying to get data from empty buffer");
+    return *actual_start_;
+}
+
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::const_reference CircularBufferBase<T, Alloc, Stats>::front() const {
+    CIRCULAR_BUFFER_CHECK(!empty(), "Trying to get data from empty buffer");
+    return *actual_start_;
+}
+
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::reference CircularBufferBase<T, Alloc, Stats>::back() {
+    CIRCULAR_BUFFER_CHECK(!empty(), "Trying to get data from empty buffer");
+    return *(actual_end_ == buff_start_ ? buff_end_ - 1 : actual_end_ - 1);
+}
+
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::const_reference CircularBufferBase<T, Alloc, Stats>::back() const {
+    CIRCULAR_BUFFER_CHECK(!empty(), "Trying to get data from empty buffer");
+    return *(actual_end_ == buff_start_ ? buff_end_ - 1 : actual_end_ - 1);
+}
+
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::allocator_type CircularBufferBase<T, Alloc, Stats>::get_allocator() const noexcept {
+    return allocator_;
+}
+
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::pointer CircularBufferBase<T, Alloc, Stats>::advance(pointer p, size_type n) const noexcept {
+    return buff_start_ + (std::distance(buff_start_, p) + n) % std::distance(buff_start_, buff_end_);
+}
+
+template<typename T, typename Alloc, typename Stats>
+template<typename U>
+RingRegions<U> CircularBufferBase<T, Alloc, Stats>::regions_from(pointer p, size_type n) const noexcept {
+    const size_type to_buff_end = std::distance(p, buff_end_);
+    if (n <= to_buff_end) {
+        return {std::span<U>(p, n), std::span<U>()};
+    }
+    return {std::span<U>(p, to_buff_end), std::span<U>(buff_start_, n - to_buff_end)};
+}
+
+template<typename T, typename Alloc, typename Stats>
+RingRegions<T> CircularBufferBase<T, Alloc, Stats>::prepare(size_type n) {
+    return regions_from<T>(actual_end_, std::min(n, capacity() - size()));
+}
+
+template<typename T, typename Alloc, typename Stats>
+void CircularBufferBase<T, Alloc, Stats>::commit(size_type n) {
+    CIRCULAR_BUFFER_CHECK(n <= capacity() - size(), "Trying to commit more elements than there are free slots");
+    actual_end_ = advance(actual_end_, n);
+    stats_.on_push(n, size());
+}
+
+template<typename T, typename Alloc, typename Stats>
+RingRegions<T> CircularBufferBase<T, Alloc, Stats>::peek(size_type n) {
+    return regions_from<T>(actual_start_, std::min(n, size()));
+}
+
+template<typename T, typename Alloc, typename Stats>
+RingRegions<const T> CircularBufferBase<T, Alloc, Stats>::peek(size_type n) const {
+    return regions_from<const T>(actual_start_, std::min(n, size()));
+}
+
+template<typename T, typename Alloc, typename Stats>
+void CircularBufferBase<T, Alloc, Stats>::consume(size_type n) {
+    CIRCULAR_BUFFER_CHECK(n <= size(), "Trying to consume more elements than there are in the buffer");
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        for (size_type i = 0; i < n; ++i) {
+            AllocTraits::destroy(allocator_, actual_start_);
+            actual_start_ = (actual_start_ + 1 == buff_end_ ? buff_start_ : actual_start_ + 1);
+        }
+    } else {
+        actual_start_ = advance(actual_start_, n);
+    }
+    if (actual_start_ == actual_end_) {
+        actual_start_ = actual_end_ = buff_start_;
+    }
+    stats_.on_pop(n);
+}
+
+template<typename T, typename Alloc, typename Stats>
+template<typename Writer>
+void CircularBufferBase<T, Alloc, Stats>::save_header(Writer& writer) const {
+    const CircularBufferSnapshotHeader header{CircularBufferSnapshotHeader::kMagic, sizeof(T), capacity(), size()};
+    writer(std::as_bytes(std::span(&header, 1)));
+}
+
+template<typename T, typename Alloc, typename Stats>
+template<typename Reader>
+CircularBufferSnapshotHeader CircularBufferBase<T, Alloc, Stats>::load_header(Reader& reader) {
+    CircularBufferSnapshotHeader header{};
+    reader(std::as_writable_bytes(std::span(&header, 1)));
+    if (header.magic != CircularBufferSnapshotHeader::kMagic || header.element_size != sizeof(T) ||
+        header.size > header.capacity) {
+        throw std::invalid_argument("Not a snapshot of this buffer type");
     }
+    return header;
+}
+
+template<typename T, typename Alloc, typename Stats>
+void CircularBufferBase<T, Alloc, Stats>::adopt(pointer new_buff_start, size_type new_capacity, size_type new_size,
+                                                size_type moved) noexcept {
+    stats_.on_reallocate(capacity(), new_capacity, moved);
     clear();
     AllocTraits::deallocate(allocator_, buff_start_, capacity() + 1);
 
-    buff_start_ = new_arr;
-    buff_end_ = new_arr + n + 1;
+    buff_start_ = new_buff_start;
+    buff_end_ = new_buff_start + new_capacity + 1;
     actual_start_ = buff_start_;
-    actual_end_ = buff_end_ - 1;
+    actual_end_ = buff_start_ + new_size;
+    record_footprint();
 }
 
-template<typename T, typename Alloc>
-template<typename LegacyInputIterator>
-requires std::input_iterator<LegacyInputIterator>
-void CircularBufferBase<T, Alloc>::assign(LegacyInputIterator i, LegacyInputIterator j) {
-    size_type new_size = std::distance(i, j);
-    pointer new_arr = AllocTraits::allocate(allocator_, new_size + 1);
+template<typename T, typename Alloc, typename Stats>
+void CircularBufferBase<T, Alloc, Stats>::steal(CircularBufferBase& other) noexcept {
+    buff_start_ = other.buff_start_;
+    buff_end_ = other.buff_end_;
+    actual_start_ = other.actual_start_;
+    actual_end_ = other.actual_end_;
+
+    other.buff_start_ = other.buff_end_ = other.actual_start_ = other.actual_end_ = nullptr;
+    record_footprint();
+}
+
+template<typename T, typename Alloc, typename Stats>
+void CircularBufferBase<T, Alloc, Stats>::record_footprint() noexcept {
+    stats_.on_footprint(std::distance(buff_start_, buff_end_) * sizeof(T));
+}
+
+template<typename T, typename Alloc, typename Stats>
+template<typename Next>
+void CircularBufferBase<T, Alloc, Stats>::assign_from(Next&& next, size_type n, size_type fresh_capacity) {
+    if (buff_start_ == nullptr || n > capacity()) {
+        pointer new_buff_start = AllocTraits::allocate(allocator_, fresh_capacity + 1);
+        size_type constructed = 0;
+        try {
+            for (; constructed < n; ++constructed) {
+                AllocTraits::construct(allocator_, new_buff_start + constructed, next());
+            }
+        } catch (...) {
+            for (size_type i = 0; i < constructed; ++i) {
+                AllocTraits::destroy(allocator_, new_buff_start + i);
+            }
+            AllocTraits::deallocate(allocator_, new_buff_start, fresh_capacity + 1);
+            throw;
+        }
+        adopt(new_buff_start, fresh_capacity, n);
+        return;
+    }
+
+    pointer slot = actual_start_;
+    const size_type assigned = std::min(n, size());
+    for (size_type i = 0; i < assigned; ++i) {
+        *slot = next();
+        slot = (slot + 1 == buff_end_ ? buff_start_ : slot + 1);
+    }
+    for (size_type i = assigned; i < n; ++i) {
+        AllocTraits::construct(allocator_, actual_end_, next());
+        actual_end_ = (actual_end_ + 1 == buff_end_ ? buff_start_ : actual_end_ + 1);
+        slot = actual_end_;
+    }
+    while (actual_end_ != slot) {
+        actual_end_ = (actual_end_ == buff_start_ ? buff_end_ - 1 : actual_end_ - 1);
+        AllocTraits::destroy(allocator_, actual_end_);
+    }
+}
+
+template<typename T, typename Alloc, typename Stats>
+void CircularBufferBase<T, Alloc, Stats>::copy_from(const CircularBufferBase& other) {
+    const size_type n = other.size();
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        if (buff_start_ != nullptr && n <= capacity()) {
+            const auto regions = other.peek(n);
+            actual_start_ = buff_start_;
+            if (!regions.first.empty()) {
+                std::memcpy(static_cast<void*>(buff_start_), regions.first.data(), regions.first.size_bytes());
+            }
+            if (!regions.second.empty()) {
+                std::memcpy(static_cast<void*>(buff_start_ + regions.first.size()), regions.second.data(),
+                            regions.second.size_bytes());
+            }
+            actual_end_ = buff_start_ + n;
+            return;
+        }
+    }
+    auto it = other.begin();
+    assign_from([&it]() -> const_reference { return *it++; }, n, other.capacity());
+}
+
+template<typename T, typename Alloc, typename Stats>
+auto CircularBufferBase<T, Alloc, Stats>::trace(BufferOperation operation) noexcept {
+    if constexpr (requires { stats_.scope(operation); }) {
+        return stats_.scope(operation);
+    } else {
+        return NoTraceScope{};
+    }
+}
+
+template<typename T, typename Alloc, typename Stats>
+const Stats& CircularBufferBase<T, Alloc, Stats>::stats() const noexcept {
+    return stats_;
+}
+
+template<typename T, typename Alloc, typename Stats>
+template<typename Writer>
+requires std::is_trivially_copyable_v<T>
+void CircularBufferBase<T, Alloc, Stats>::save(Writer&& writer) const {
+    save_header(writer);
+    const auto regions = peek(size());
+    writer(std::as_bytes(regions.first));
+    if (!regions.second.empty()) {
+        writer(std::as_bytes(regions.second));
+    }
+}
+
+template<typename T, typename Alloc, typename Stats>
+template<typename Writer, typename ElementWriter>
+void CircularBufferBase<T, Alloc, Stats>::save(Writer&& writer, ElementWriter&& element_writer) const {
+    save_header(writer);
+    for (auto it = cbegin(); it != cend(); ++it) {
+        element_writer(writer, *it);
+    }
+}
+
+template<typename T, typename Alloc, typename Stats>
+template<typename Reader>
+requires std::is_trivially_copyable_v<T>
+void CircularBufferBase<T, Alloc, Stats>::load(Reader&& reader) {
+    const auto header = load_header(reader);
+    pointer new_buff_start = AllocTraits::allocate(allocator_, header.capacity + 1);
     try {
-        my_uninitialized_copy(i, j, new_arr, allocator_);
+        reader(std::as_writable_bytes(std::span(new_buff_start, header.size)));
     } catch (...) {
-        AllocTraits::deallocate(allocator_, new_arr, new_size + 1);
+        AllocTraits::deallocate(allocator_, new_buff_start, header.capacity + 1);
         throw;
     }
+    adopt(new_buff_start, header.capacity, header.size);
+}
 
-    clear();
-    AllocTraits::deallocate(allocator_, buff_start_, capacity() + 1);
+template<typename T, typename Alloc, typename Stats>
+template<typename Reader, typename ElementReader>
+void CircularBufferBase<T, Alloc, Stats>::load(Reader&& reader, ElementReader&& element_reader) {
+    const auto header = load_header(reader);
+    pointer new_buff_start = AllocTraits::allocate(allocator_, header.capacity + 1);
+    size_type constructed = 0;
+    try {
+        for (; constructed < header.size; ++constructed) {
+            AllocTraits::construct(allocator_, new_buff_start + constructed, element_reader(reader));
+        }
+    } catch (...) {
+        for (size_type i = 0; i < constructed; ++i) {
+            AllocTraits::destroy(allocator_, new_buff_start + i);
+        }
+        AllocTraits::deallocate(allocator_, new_buff_start, header.capacity + 1);
+        throw;
+    }
+    adopt(new_buff_start, header.capacity, header.size);
+}
 
-    buff_start_ = new_arr;
-    buff_end_ = new_arr + new_size + 1;
-    actual_start_ = buff_start_;
-    actual_end_ = buff_end_ - 1;
+template<typename T, typename Alloc, typename Stats>
+bool CircularBufferBase<T, Alloc, Stats>::is_full() const noexcept {
+    return advance(actual_end_, 1) == actual_start_;
 }
 
-template<typename T, typename Alloc>
-void CircularBufferBase<T, Alloc>::assign(const std::initializer_list<value_type>& il) {
-    assign(il.begin(), il.end());
+template<typename T, typename Alloc, typename Stats>
+bool CircularBufferBase<T, Alloc, Stats>::owns(const_iterator q) const noexcept {
+    return std::addressof(*q) >= buff_start_ && std::addressof(*q) < buff_end_;
 }
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::reference CircularBufferBase<T, Alloc>::front() {
-    if (empty()) {
-        throw std::out_of_range("Trying to get data from empty buffer");
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::pointer CircularBufferBase<T, Alloc, Stats>::open_gap(size_type index, size_type n) {
+    const size_type old_size = size();
+    if (n == 0) {
+        return advance(actual_start_, index);
     }
-    return *actual_start_;
+    if (index < old_size - index) {
+        const pointer new_start = advance(actual_start_, std::distance(buff_start_, buff_end_) - n);
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            ring_move(new_start, actual_start_, index, true);
+        } else {
+            pointer dst = new_start;
+            pointer src = actual_start_;
+            for (size_type k = 0; k < index; ++k, dst = advance(dst, 1), src = advance(src, 1)) {
+                if (k < n) {
+                    AllocTraits::construct(allocator_, dst, std::move_if_noexcept(*src));
+                } else {
+                    *dst = std::move_if_noexcept(*src);
+                }
+            }
+            for (size_type k = (index > n ? index - n : 0); k < index; ++k) {
+                AllocTraits::destroy(allocator_, advance(actual_start_, k));
+            }
+        }
+        actual_start_ = new_start;
+    } else {
+        const size_type tail = old_size - index;
+        const pointer src = advance(actual_start_, index);
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            ring_move(advance(src, n), src, tail, false);
+        } else {
+            for (size_type k = tail; k-- > 0;) {
+                pointer from = advance(src, k);
+                pointer to = advance(src, k + n);
+                if (index + k + n >= old_size) {
+                    AllocTraits::construct(allocator_, to, std::move_if_noexcept(*from));
+                } else {
+                    *to = std::move_if_noexcept(*from);
+                }
+            }
+            for (size_type k = 0; k < std::min(tail, n); ++k) {
+                AllocTraits::destroy(allocator_, advance(src, k));
+            }
+        }
+        actual_end_ = advance(actual_end_, n);
+    }
+    return advance(actual_start_, index);
 }
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::const_reference CircularBufferBase<T, Alloc>::front() const {
-    if (empty()) {
-        throw std::out_of_range("Trying to get data from empty buffer");
+template<typename T, typename Alloc, typename Stats>
+void CircularBufferBase<T, Alloc, Stats>::close_gap(size_type index, size_type n) {
+    const size_type old_size = size();
+    if (n == 0) {
+        return;
+    }
+    for (size_type k = 0; k < n; ++k) {
+        AllocTraits::destroy(allocator_, advance(actual_start_, index + k));
+    }
+    const size_type tail = old_size - index - n;
+    if (index < tail) {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            ring_move(advance(actual_start_, n), actual_start_, index, false);
+        } else {
+            for (size_type k = index; k-- > 0;) {
+                pointer from = advance(actual_start_, k);
+                pointer to = advance(actual_start_, k + n);
+                if (k + n >= index) {
+                    AllocTraits::construct(allocator_, to, std::move_if_noexcept(*from));
+                } else {
+                    *to = std::move_if_noexcept(*from);
+                }
+            }
+            for (size_type k = 0; k < std::min(index, n); ++k) {
+                AllocTraits::destroy(allocator_, advance(actual_start_, k));
+            }
+        }
+        actual_start_ = advance(actual_start_, n);
+    } else {
+        const pointer dst = advance(actual_start_, index);
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            ring_move(dst, advance(dst, n), tail, true);
+        } else {
+            for (size_type k = 0; k < tail; ++k) {
+                pointer from = advance(dst, k + n);
+                pointer to = advance(dst, k);
+                if (k < n) {
+                    AllocTraits::construct(allocator_, to, std::move_if_noexcept(*from));
+                } else {
+                    *to = std::move_if_noexcept(*from);
+                }
+            }
+            for (size_type k = (tail > n ? tail : n); k < tail + n; ++k) {
+                AllocTraits::destroy(allocator_, advance(dst, k));
+            }
+        }
+        actual_end_ = advance(actual_end_, std::distance(buff_start_, buff_end_) - n);
     }
-    return *actual_start_;
 }
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::reference CircularBufferBase<T, Alloc>::back() {
-    if (empty()) {
-        throw std::out_of_range("Trying to get data from empty buffer");
+template<typename T, typename Alloc, typename Stats>
+void CircularBufferBase<T, Alloc, Stats>::ring_move(pointer dst, pointer src, size_type n, bool forward) noexcept {
+    if (forward) {
+        while (n > 0) {
+            const size_type chunk = std::min({n, static_cast<size_type>(std::distance(src, buff_end_)),
+                                              static_cast<size_type>(std::distance(dst, buff_end_))});
+            std::memmove(static_cast<void*>(dst), src, chunk * sizeof(T));
+            src = advance(src, chunk);
+            dst = advance(dst, chunk);
+            n -= chunk;
+        }
+        return;
+    }
+    pointer src_end = advance(src, n);
+    pointer dst_end = advance(dst, n);
+    while (n > 0) {
+        src_end = (src_end == buff_start_ ? buff_end_ : src_end);
+        dst_end = (dst_end == buff_start_ ? buff_end_ : dst_end);
+        const size_type chunk = std::min({n, static_cast<size_type>(std::distance(buff_start_, src_end)),
+                                          static_cast<size_type>(std::distance(buff_start_, dst_end))});
+        src_end -= chunk;
+        dst_end -= chunk;
+        std::memmove(static_cast<void*>(dst_end), src_end, chunk * sizeof(T));
+        n -= chunk;
     }
-    return *(actual_end_ == buff_start_ ? buff_end_ - 1 : actual_end_ - 1);
 }
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::const_reference CircularBufferBase<T, Alloc>::back() const {
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::pointer CircularBufferBase<T, Alloc, Stats>::try_front() noexcept {
+    return empty() ? nullptr : actual_start_;
+}
+
+template<typename T, typename Alloc, typename Stats>
+const T* CircularBufferBase<T, Alloc, Stats>::try_front() const noexcept {
+    return empty() ? nullptr : actual_start_;
+}
+
+template<typename T, typename Alloc, typename Stats>
+CircularBufferBase<T, Alloc, Stats>::pointer CircularBufferBase<T, Alloc, Stats>::try_back() noexcept {
+    return empty() ? nullptr : (actual_end_ == buff_start_ ? buff_end_ - 1 : actual_end_ - 1);
+}
+
+template<typename T, typename Alloc, typename Stats>
+const T* CircularBufferBase<T, Alloc, Stats>::try_back() const noexcept {
+    return empty() ? nullptr : (actual_end_ == buff_start_ ? buff_end_ - 1 : actual_end_ - 1);
+}
+
+template<typename T, typename Alloc, typename Stats>
+std::optional<typename CircularBufferBase<T, Alloc, Stats>::value_type>
+CircularBufferBase<T, Alloc, Stats>::try_pop_back() {
+    [[maybe_unused]] auto scope = trace(BufferOperation::pop_back);
+    std::optional<value_type> result;
     if (empty()) {
-        throw std::out_of_range("Trying to get data from empty buffer");
+        return result;
     }
-    return *(actual_end_ == buff_start_ ? buff_end_ - 1 : actual_end_ - 1);
+    auto last = (actual_end_ == buff_start_ ? buff_end_ - 1 : actual_end_ - 1);
+    result.emplace(std::move(*last));
+    AllocTraits::destroy(allocator_, last);
+    actual_end_ = last;
+    stats_.on_pop(1);
+    return result;
 }
 
-template<typename T, typename Alloc>
-CircularBufferBase<T, Alloc>::allocator_type CircularBufferBase<T, Alloc>::get_allocator() const noexcept {
-    return allocator_;
+template<typename T, typename Alloc, typename Stats>
+std::optional<typename CircularBufferBase<T, Alloc, Stats>::value_type>
+CircularBufferBase<T, Alloc, Stats>::try_pop_front() {
+    std::optional<value_type> result;
+    consume_front([&result](reference value) {
+        result.emplace(std::move(value));
+    });
+    return result;
+}
+
+template<typename T, typename Alloc, typename Stats>
+bool CircularBufferBase<T, Alloc, Stats>::try_push_back(const_reference value) {
+    return try_emplace_back(value);
+}
+
+template<typename T, typename Alloc, typename Stats>
+bool CircularBufferBase<T, Alloc, Stats>::try_push_back(value_type&& value) {
+    return try_emplace_back(std::move(value));
+}
+
+template<typename T, typename Alloc, typename Stats>
+template<typename... Args>
+bool CircularBufferBase<T, Alloc, Stats>::try_emplace_back(Args&& ... args) {
+    [[maybe_unused]] auto scope = trace(BufferOperation::push_back);
+    if (is_full()) {
+        return false;
+    }
+    AllocTraits::construct(allocator_, actual_end_, std::forward<Args>(args)...);
+    actual_end_ = (actual_end_ + 1 == buff_end_ ? buff_start_ : actual_end_ + 1);
+    stats_.on_push(1, size());
+    return true;
+}
+
+template<typename T, typename Alloc, typename Stats>
+bool CircularBufferBase<T, Alloc, Stats>::try_push_front(const_reference value) {
+    [[maybe_unused]] auto scope = trace(BufferOperation::push_front);
+    if (is_full()) {
+        return false;
+    }
+    auto new_start = (actual_start_ == buff_start_ ? buff_end_ - 1 : actual_start_ - 1);
+    AllocTraits::construct(allocator_, new_start, value);
+    actual_start_ = new_start;
+    stats_.on_push(1, size());
+    return true;
+}
+
+template<typename T, typename Alloc, typename Stats>
+bool CircularBufferBase<T, Alloc, Stats>::try_push_front(value_type&& value) {
+    [[maybe_unused]] auto scope = trace(BufferOperation::push_front);
+    if (is_full()) {
+        return false;
+    }
+    auto new_start = (actual_start_ == buff_start_ ? buff_end_ - 1 : actual_start_ - 1);
+    AllocTraits::construct(allocator_, new_start, std::move(value));
+    actual_start_ = new_start;
+    stats_.on_push(1, size());
+    return true;
+}
+
+template<typename T, typename Alloc, typename Stats>
+std::expected<typename CircularBufferBase<T, Alloc, Stats>::iterator, BufferError>
+CircularBufferBase<T, Alloc, Stats>::try_erase(const_iterator q) {
+    if (!owns(q) || static_cast<size_type>(q - cbegin()) >= size()) {
+        return std::unexpected(BufferError::out_of_range);
+    }
+    return erase(q);
+}
+
+template<typename T, typename Alloc, typename Stats>
+std::expected<typename CircularBufferBase<T, Alloc, Stats>::iterator, BufferError>
+CircularBufferBase<T, Alloc, Stats>::try_erase(const_iterator q1, const_iterator q2) {
+    if (!owns(q1) || !owns(q2) || q2 < q1 || static_cast<size_type>(q2 - cbegin()) > size()) {
+        return std::unexpected(BufferError::out_of_range);
+    }
+    if (q1 == q2) {
+        return begin() + (q1 - cbegin());
+    }
+    return erase(q1, q2);
+}
+
+template<typename T, typename Alloc, typename Stats>
+template<typename Predicate>
+CircularBufferBase<T, Alloc, Stats>::size_type CircularBufferBase<T, Alloc, Stats>::erase_if(Predicate pred) {
+    [[maybe_unused]] auto scope = trace(BufferOperation::erase);
+    const size_type old_size = size();
+    size_type kept = 0;
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        size_type run_start = 0;
+        pointer p = actual_start_;
+        for (size_type i = 0; i <= old_size; ++i, p = advance(p, 1)) {
+            if (i < old_size && !pred(*p)) {
+                continue;
+            }
+            const size_type run = i - run_start;
+            if (run > 0 && kept != run_start) {
+                ring_move(advance(actual_start_, kept), advance(actual_start_, run_start), run, true);
+            }
+            kept += run;
+            run_start = i + 1;
+        }
+    } else {
+        pointer dst = actual_start_;
+        for (pointer src = actual_start_; src != actual_end_; src = advance(src, 1)) {
+            if (pred(*src)) {
+                continue;
+            }
+            if (dst != src) {
+                *dst = std::move(*src);
+            }
+            dst = advance(dst, 1);
+            ++kept;
+        }
+        for (pointer p = dst; p != actual_end_; p = advance(p, 1)) {
+            AllocTraits::destroy(allocator_, p);
+        }
+    }
+    actual_end_ = advance(actual_start_, kept);
+    stats_.on_pop(old_size - kept);
+    return old_size - kept;
+}
+
+template<typename T, typename Alloc, typename Stats>
+template<typename Predicate>
+CircularBufferBase<T, Alloc, Stats>::size_type CircularBufferBase<T, Alloc, Stats>::retain(Predicate pred) {
+    return erase_if([&pred](const_reference value) { return !pred(value); });
 }
@@ -2,50 +2,53 @@
 
 #include "CircularBufferBase.hpp"
 
-template<typename T, std::size_t scale_factor = 2, typename Alloc = std::allocator<T>>
-class CircularBufferExt : protected CircularBufferBase<T, Alloc> {
+#include <memory_resource>
+
+template<typename T, std::size_t scale_factor = 2, typename Alloc = std::allocator<T>, typename Stats = NoBufferStats>
+class CircularBufferExt : protected CircularBufferBase<T, Alloc, Stats> {
 public:
     USING_FIELDS;
 
-    explicit CircularBufferExt(const Alloc& allocator = Alloc()) : CircularBufferBase<T, Alloc>(allocator) {}
+    explicit CircularBufferExt(const Alloc& allocator = Alloc()) : CircularBufferBase<T, Alloc, Stats>(allocator) {}
 
-    explicit CircularBufferExt(CircularBufferBase<T, Alloc>::size_type n, const Alloc& allocator = Alloc())
-            : CircularBufferBase<T, Alloc>(n, allocator) {}
+    explicit CircularBufferExt(CircularBufferBase<T, Alloc, Stats>::size_type n, const Alloc& allocator = Alloc())
+            : CircularBufferBase<T, Alloc, Stats>(n, allocator) {}
 
-    CircularBufferExt(CircularBufferBase<T, Alloc>::size_type n,
-                      CircularBufferBase<T, Alloc>::value_type value,
-                      const Alloc& allocator = Alloc()) : CircularBufferBase<T, Alloc>(n, value, allocator) {}
+    CircularBufferExt(CircularBufferBase<T, Alloc, Stats>::size_type n,
+                      CircularBufferBase<T, Alloc, Stats>::value_type value,
+                      const Alloc& allocator = Alloc()) : CircularBufferBase<T, Alloc, Stats>(n, value, allocator) {}
 
-    CircularBufferExt(const CircularBufferExt<T, scale_factor, Alloc>& other) : CircularBufferBase<T, Alloc>(other) {}
+    CircularBufferExt(const CircularBufferExt<T, scale_factor, Alloc, Stats>& other) : CircularBufferBase<T, Alloc, Stats>(other) {}
 
-    CircularBufferExt(CircularBufferExt<T, scale_factor, Alloc>&& other) noexcept: CircularBufferBase<T, Alloc>(std::move(other)) {}
+    CircularBufferExt(CircularBufferExt<T, scale_factor, Alloc, Stats>&& other) noexcept: CircularBufferBase<T, Alloc, Stats>(std::move(other)) {}
 
     template<typename LegacyInputIterator>
     CircularBufferExt(LegacyInputIterator i, LegacyInputIterator j, const Alloc& allocator = Alloc())
-            : CircularBufferBase<T, Alloc>(i, j, allocator) {}
+            : CircularBufferBase<T, Alloc, Stats>(i, j, allocator) {}
 
     CircularBufferExt(const std::initializer_list<value_type>& list, const Alloc& allocator = Alloc())
-            : CircularBufferBase<T, Alloc>(list, allocator) {}
+            : CircularBufferBase<T, Alloc, Stats>(list, allocator) {}
 
     ~CircularBufferExt() {
-        clear();
-        AllocTraits::deallocate(allocator_, buff_start_, capacity() + 1);
+        if (buff_start_ != nullptr) {
+            clear();
+            AllocTraits::deallocate(allocator_, buff_start_, capacity() + 1);
+        }
     }
 
     CircularBufferExt& operator=(const CircularBufferExt& other) {
-        static_cast<CircularBufferBase<T, Alloc>&>(*this).operator=(
-                static_cast<CircularBufferBase<T, Alloc>&>(other));
+        CircularBufferBase<T, Alloc, Stats>::operator=(other);
         return *this;
     }
 
-    CircularBufferExt& operator=(CircularBufferExt&& other) noexcept {
-        static_cast<CircularBufferBase<T, Alloc>&>(*this).operator=(
-                std::move(static_cast<CircularBufferBase<T, Alloc>&>(other)));
+    CircularBufferExt& operator=(CircularBufferExt&& other) noexcept(AllocTraits::propagate_on_container_move_assignment::value ||
+                                                 AllocTraits::is_always_equal::value) {
+        CircularBufferBase<T, Alloc, Stats>::operator=(std::move(other));
         return *this;
     }
 
     void swap(CircularBufferExt& other) {
-        static_cast<CircularBufferBase<T, Alloc>&>(*this).swap(static_cast<CircularBufferBase<T, Alloc>&>(other));
+        static_cast<CircularBufferBase<T, Alloc, Stats>&>(*this).swap(static_cast<CircularBufferBase<T, Alloc, Stats>&>(other));
     }
 
     void push_back(const T& value);
@@ -77,16 +80,26 @@ public:
 
     iterator insert(const_iterator p, const std::initializer_list<value_type>& il);
 
+    // insert() that reports a position outside [begin(), end()] instead of throwing.
+    std::expected<iterator, BufferError> try_insert(const_iterator p, const_reference value);
+
+    std::expected<iterator, BufferError> try_insert(const_iterator p, value_type&& rv);
+
     bool operator==(const CircularBufferExt& other) const noexcept;
 
     bool operator!=(const CircularBufferExt& other) const noexcept;
 
 protected:
-    using CircularBufferBase<T, Alloc>::buff_start_;
-    using CircularBufferBase<T, Alloc>::buff_end_;
-    using CircularBufferBase<T, Alloc>::actual_start_;
-    using CircularBufferBase<T, Alloc>::actual_end_;
-    using CircularBufferBase<T, Alloc>::allocator_;
+    using CircularBufferBase<T, Alloc, Stats>::buff_start_;
+    using CircularBufferBase<T, Alloc, Stats>::buff_end_;
+    using CircularBufferBase<T, Alloc, Stats>::actual_start_;
+    using CircularBufferBase<T, Alloc, Stats>::actual_end_;
+    using CircularBufferBase<T, Alloc, Stats>::allocator_;
+    using CircularBufferBase<T, Alloc, Stats>::stats_;
+    using CircularBufferBase<T, Alloc, Stats>::trace;
+    using CircularBufferBase<T, Alloc, Stats>::owns;
+    using CircularBufferBase<T, Alloc, Stats>::advance;
+    using CircularBufferBase<T, Alloc, Stats>::open_gap;
 
 private:
     inline void reserve_if_full(size_type current_size, size_type current_capacity) {
@@ -96,274 +109,208 @@ private:
     }
 };
 
-template<typename T, std::size_t scale_factor, typename Alloc>
-void CircularBufferExt<T, scale_factor, Alloc>::push_back(const T& value) {
+template<typename T, std::size_t scale_factor, typename Alloc, typename Stats>
+void CircularBufferExt<T, scale_factor, Alloc, Stats>::push_back(const T& value) {
+    [[maybe_unused]] auto scope = trace(BufferOperation::push_back);
     reserve_if_full(size(), capacity());
     AllocTraits::construct(allocator_, actual_end_, value);
     actual_end_ = (actual_end_ + 1 == buff_end_ ? buff_start_ : actual_end_ + 1);
+    stats_.on_push(1, size());
 }
 
-template<typename T, std::size_t scale_factor, typename Alloc>
-void CircularBufferExt<T, scale_factor, Alloc>::push_back(T&& value) {
+template<typename T, std::size_t scale_factor, typename Alloc, typename Stats>
+void CircularBufferExt<T, scale_factor, Alloc, Stats>::push_back(T&& value) {
+    [[maybe_unused]] auto scope = trace(BufferOperation::push_back);
     reserve_if_full(size(), capacity());
     AllocTraits::construct(allocator_, actual_end_, std::move(value));
     actual_end_ = (actual_end_ + 1 == buff_end_ ? buff_start_ : actual_end_ + 1);
+    stats_.on_push(1, size());
 }
 
-template<typename T, std::size_t scale_factor, typename Alloc>
+template<typename T, std::size_t scale_factor, typename Alloc, typename Stats>
 template<typename... Args>
-void CircularBufferExt<T, scale_factor, Alloc>::emplace_back(Args&& ... args) {
+void CircularBufferExt<T, scale_factor, Alloc, Stats>::emplace_back(Args&& ... args) {
+    [[maybe_unused]] auto scope = trace(BufferOperation::push_back);
     reserve_if_full(size(), capacity());
     AllocTraits::construct(allocator_, actual_end_, value_type(std::forward<Args>(args)...));
     actual_end_ = (actual_end_ + 1 == buff_end_ ? buff_start_ : actual_end_ + 1);
+    stats_.on_push(1, size());
 }
 
-template<typename T, std::size_t scale_factor, typename Alloc>
-void CircularBufferExt<T, scale_factor, Alloc>::push_front(const T& value) {
+template<typename T, std::size_t scale_factor, typename Alloc, typename Stats>
+void CircularBufferExt<T, scale_factor, Alloc, Stats>::push_front(const T& value) {
+    [[maybe_unused]] auto scope = trace(BufferOperation::push_front);
     reserve_if_full(size(), capacity());
     auto new_start = (actual_start_ == buff_start_ ? buff_end_ - 1 : actual_start_ - 1);
     AllocTraits::construct(allocator_, new_start, value);
     actual_start_ = new_start;
+    stats_.on_push(1, size());
 }
 
-template<typename T, std::size_t scale_factor, typename Alloc>
-void CircularBufferExt<T, scale_factor, Alloc>::push_front(T&& value) {
+template<typename T, std::size_t scale_factor, typename Alloc, typename Stats>
+void CircularBufferExt<T, scale_factor, Alloc, Stats>::push_front(T&& value) {
+    [[maybe_unused]] auto scope = trace(BufferOperation::push_front);
     reserve_if_full(size(), capacity());
     auto new_start = (actual_start_ == buff_start_ ? buff_end_ - 1 : actual_start_ - 1);
     AllocTraits::construct(allocator_, new_start, std::move(value));
     actual_start_ = new_start;
+    stats_.on_push(1, size());
 }
 
-template<typename T, std::size_t scale_factor, typename Alloc>
+template<typename T, std::size_t scale_factor, typename Alloc, typename Stats>
 template<typename... Args>
-void CircularBufferExt<T, scale_factor, Alloc>::emplace_front(Args&& ... args) {
+void CircularBufferExt<T, scale_factor, Alloc, Stats>::emplace_front(Args&& ... args) {
+    [[maybe_unused]] auto scope = trace(BufferOperation::push_front);
     reserve_if_full(size(), capacity());
     auto new_start = (actual_start_ == buff_start_ ? buff_end_ - 1 : actual_start_ - 1);
     AllocTraits::construct(allocator_, new_start, value_type(std::forward<Args>(args)...));
     actual_start_ = new_start;
+    stats_.on_push(1, size());
 }
 
-template<typename T, std::size_t scale_factor, typename Alloc>
-CircularBufferExt<T, scale_factor, Alloc>::iterator
-CircularBufferExt<T, scale_factor, Alloc>::insert(CircularBufferExt<T, scale_factor, Alloc>::const_iterator p, const_reference value) {
-    if (std::addressof(*p) < buff_start_ || std::addressof(*p) >= buff_end_) {
-        throw std::out_of_range("Iterator is out of bounds");
-    }
+template<typename T, std::size_t scale_factor, typename Alloc, typename Stats>
+CircularBufferExt<T, scale_factor, Alloc, Stats>::iterator
+CircularBufferExt<T, scale_factor, Alloc, Stats>::insert(const_iterator p, const_reference value) {
+    [[maybe_unused]] auto scope = trace(BufferOperation::insert);
+    CIRCULAR_BUFFER_CHECK(std::addressof(*p) >= buff_start_ && std::addressof(*p) < buff_end_,
+                          "Iterator is out of bounds");
     size_type index = p - begin();
-    if (index > size()) {
-        throw std::out_of_range("Iterator is out of bounds");
-    }
+    CIRCULAR_BUFFER_CHECK(index <= size(), "Iterator is out of bounds");
 
     reserve_if_full(size(), capacity());
-    if (index == size()) {
-        push_back(value);
-        return --end();
-    }
-    if (index == 0) {
-        push_front(value);
-        return begin();
-    }
-
-    auto last = --end();
-    p = begin() + index;
-    AllocTraits::construct(allocator_, actual_end_, std::move_if_noexcept(*last));
-    actual_end_ = (actual_end_ + 1 == buff_end_ ? buff_start_ : actual_end_ + 1);
-    for (; last != p; --last) {
-        *last = std::move_if_noexcept(*(last - 1));
-    }
-    *p = value;
-    return p;
+    AllocTraits::construct(allocator_, open_gap(index, 1), value);
+    stats_.on_push(1, size());
+    return begin() + index;
 }
 
-template<typename T, std::size_t scale_factor, typename Alloc>
-CircularBufferExt<T, scale_factor, Alloc>::iterator
-CircularBufferExt<T, scale_factor, Alloc>::insert(CircularBufferExt<T, scale_factor, Alloc>::const_iterator p, value_type&& rv) {
-    if (std::addressof(*p) < buff_start_ || std::addressof(*p) >= buff_end_) {
-        throw std::out_of_range("Iterator is out of bounds");
-    }
+template<typename T, std::size_t scale_factor, typename Alloc, typename Stats>
+CircularBufferExt<T, scale_factor, Alloc, Stats>::iterator
+CircularBufferExt<T, scale_factor, Alloc, Stats>::insert(const_iterator p, value_type&& rv) {
+    [[maybe_unused]] auto scope = trace(BufferOperation::insert);
+    CIRCULAR_BUFFER_CHECK(std::addressof(*p) >= buff_start_ && std::addressof(*p) < buff_end_,
+                          "Iterator is out of bounds");
     size_type index = p - begin();
-    if (index > size()) {
-        throw std::out_of_range("Iterator is out of bounds");
-    }
+    CIRCULAR_BUFFER_CHECK(index <= size(), "Iterator is out of bounds");
 
     reserve_if_full(size(), capacity());
-    if (index == size()) {
-        push_back(std::move(rv));
-        return --end();
-    }
-    if (index == 0) {
-        push_front(std::move(rv));
-        return begin();
-    }
-    auto last = --end();
-    auto it = begin() + index;
-    AllocTraits::construct(allocator_, actual_end_, std::move_if_noexcept(*last));
-    actual_end_ = (actual_end_ + 1 == buff_end_ ? buff_start_ : actual_end_ + 1);
-    for (; last != it; --last) {
-        *last = std::move_if_noexcept(*(last - 1));
-    }
-    *it = std::move_if_noexcept(rv);
-    return it;
+    AllocTraits::construct(allocator_, open_gap(index, 1), std::move(rv));
+    stats_.on_push(1, size());
+    return begin() + index;
 }
 
-
-template<typename T, std::size_t scale_factor, typename Alloc>
-CircularBufferExt<T, scale_factor, Alloc>::iterator
-CircularBufferExt<T, scale_factor, Alloc>::insert(CircularBufferExt<T, scale_factor, Alloc>::const_iterator p,
-                                    CircularBufferExt<T, scale_factor, Alloc>::size_type n,
-                                    const_reference value) {
-    if (std::addressof(*p) < buff_start_ || std::addressof(*p) >= buff_end_) {
-        throw std::out_of_range("Iterator is out of bounds");
-    }
+template<typename T, std::size_t scale_factor, typename Alloc, typename Stats>
+CircularBufferExt<T, scale_factor, Alloc, Stats>::iterator
+CircularBufferExt<T, scale_factor, Alloc, Stats>::insert(const_iterator p, size_type n, const_reference value) {
+    [[maybe_unused]] auto scope = trace(BufferOperation::insert);
+    CIRCULAR_BUFFER_CHECK(std::addressof(*p) >= buff_start_ && std::addressof(*p) < buff_end_,
+                          "Iterator is out of bounds");
     size_type index = p - begin();
     if (n == 0) {
         return begin() + index;
     }
-    if (index > size()) {
-        throw std::out_of_range("Iterator is out of bounds");
-    }
+    CIRCULAR_BUFFER_CHECK(index <= size(), "Iterator is out of bounds");
 
-    size_type target_capacity = capacity();
+    size_type target_capacity = std::max<size_type>(capacity(), 1);
     while (target_capacity < size() + n) {
-        target_capacity *= 2;
+        target_capacity *= scale_factor;
     }
     reserve(target_capacity);
-    if (index == size()) {
-        auto it = end();
-        for (size_type i = 0; i < n; ++i) {
-            push_back(value);
-        }
-        return it;
-    }
-    if (index == 0) {
-        for (size_type i = 0; i < n; ++i) {
-            push_front(value);
-        }
-        return begin();
-    }
-
-    actual_end_ = (actual_end_ + n >= buff_end_ ? actual_end_ = buff_start_ + ((actual_end_ + n) - buff_end_) :
-                   actual_end_ + n);
-
-    auto to_insert = begin() + index;
-    for (auto it = end() - n; it != to_insert; --it) {
-        AllocTraits::construct(allocator_, std::addressof(*(it + n - 1)), std::move_if_noexcept(*(it - 1)));
-    }
-    for (size_type i = 0; i < n; ++i) {
-        AllocTraits::construct(allocator_, std::addressof(to_insert[i]), value);
+    pointer slot = open_gap(index, n);
+    for (size_type k = 0; k < n; ++k, slot = advance(slot, 1)) {
+        AllocTraits::construct(allocator_, slot, value);
     }
-
-    return to_insert;
+    stats_.on_push(n, size());
+    return begin() + index;
 }
 
-template<typename T, std::size_t scale_factor, typename Alloc>
+template<typename T, std::size_t scale_factor, typename Alloc, typename Stats>
 template<typename... Args>
-CircularBufferExt<T, scale_factor, Alloc>::iterator
-CircularBufferExt<T, scale_factor, Alloc>::emplace(CircularBufferExt<T, scale_factor, Alloc>::const_iterator p, Args&& ... args) {
-    if (std::addressof(*p) < buff_start_ || std::addressof(*p) >= buff_end_) {
-        throw std::out_of_range("Iterator is out of bounds");
-    }
+CircularBufferExt<T, scale_factor, Alloc, Stats>::iterator
+CircularBufferExt<T, scale_factor, Alloc, Stats>::emplace(const_iterator p, Args&& ... args) {
+    [[maybe_unused]] auto scope = trace(BufferOperation::insert);
+    CIRCULAR_BUFFER_CHECK(std::addressof(*p) >= buff_start_ && std::addressof(*p) < buff_end_,
+                          "Iterator is out of bounds");
     size_type index = p - begin();
-    if (index > size()) {
-        throw std::out_of_range("Iterator is out of bounds");
-    }
+    CIRCULAR_BUFFER_CHECK(index <= size(), "Iterator is out of bounds");
 
     reserve_if_full(size(), capacity());
-
-    if (index == size()) {
-        emplace_back(std::forward<Args>(args)...);
-        return --end();
-    }
-    if (index == 0) {
-        push_front(std::forward<Args>(args)...);
-        return begin();
-    }
-    auto last = --end();
-    p = begin() + index;
-    AllocTraits::construct(allocator_, actual_end_, std::move_if_noexcept(*last));
-    actual_end_ = (actual_end_ + 1 == buff_end_ ? buff_start_ : actual_end_ + 1);
-    for (; last != p; --last) {
-        *last = std::move_if_noexcept(*(last - 1));
-    }
-    *p = value_type(std::forward<Args>(args)...);
-    return p;
+    AllocTraits::construct(allocator_, open_gap(index, 1), std::forward<Args>(args)...);
+    stats_.on_push(1, size());
+    return begin() + index;
 }
 
-template<typename T, std::size_t scale_factor, typename Alloc>
+template<typename T, std::size_t scale_factor, typename Alloc, typename Stats>
 template<typename LegacyInputIterator>
 requires std::input_iterator<LegacyInputIterator>
-CircularBufferExt<T, scale_factor, Alloc>::iterator
-CircularBufferExt<T, scale_factor, Alloc>::insert(CircularBufferExt<T, scale_factor, Alloc>::const_iterator p, LegacyInputIterator i,
-                                    LegacyInputIterator j) {
-    if (std::addressof(*p) < buff_start_ || std::addressof(*p) >= buff_end_) {
-        throw std::out_of_range("Iterator is out of bounds");
-    }
-    size_type n = std::distance(i, j);
+CircularBufferExt<T, scale_factor, Alloc, Stats>::iterator
+CircularBufferExt<T, scale_factor, Alloc, Stats>::insert(const_iterator p, LegacyInputIterator i, LegacyInputIterator j) {
+    [[maybe_unused]] auto scope = trace(BufferOperation::insert);
+    CIRCULAR_BUFFER_CHECK(std::addressof(*p) >= buff_start_ && std::addressof(*p) < buff_end_,
+                          "Iterator is out of bounds");
     size_type index = p - begin();
+    size_type n = std::distance(i, j);
     if (n == 0) {
         return begin() + index;
     }
-    if (index > size()) {
-        throw std::out_of_range("Iterator is out of bounds");
-    }
+    CIRCULAR_BUFFER_CHECK(index <= size(), "Iterator is out of bounds");
 
-    size_type target_capacity = capacity();
+    size_type target_capacity = std::max<size_type>(capacity(), 1);
     while (target_capacity < size() + n) {
-        target_capacity *= 2;
+        target_capacity *= scale_factor;
     }
     reserve(target_capacity);
-
-    if (index == size()) {
-        auto it = end();
-        for (; i != j; ++i) {
-            push_back(*i);
-        }
-        return it;
-    }
-    if (index == 0) {
-        for (; i != j; ++i) {
-            push_front(*i);
-        }
-        return begin();
+    pointer slot = open_gap(index, n);
+    for (; i != j; ++i, slot = advance(slot, 1)) {
+        AllocTraits::construct(allocator_, slot, *i);
     }
+    stats_.on_push(n, size());
+    return begin() + index;
+}
 
-    actual_end_ = (actual_end_ + n >= buff_end_ ? actual_end_ = buff_start_ + ((actual_end_ + n) - buff_end_) :
-                   actual_end_ + n);
+template<typename T, std::size_t scale_factor, typename Alloc, typename Stats>
+CircularBufferExt<T, scale_factor, Alloc, Stats>::iterator
+CircularBufferExt<T, scale_factor, Alloc, Stats>::insert(const_iterator p, const std::initializer_list<value_type>& il) {
+    return insert(p, il.begin(), il.end());
+}
 
-    auto to_insert = begin() + index;
-    for (auto it = end() - n; it != to_insert; --it) {
-        AllocTraits::construct(allocator_, std::addressof(*(it + n - 1)), std::move_if_noexcept(*(it - 1)));
-    }
-    for (size_type k = 0; k < n; ++i, ++k) {
-        AllocTraits::construct(allocator_, std::addressof(to_insert[k]), *i);
+template<typename T, std::size_t scale_factor, typename Alloc, typename Stats>
+std::expected<typename CircularBufferExt<T, scale_factor, Alloc, Stats>::iterator, BufferError>
+CircularBufferExt<T, scale_factor, Alloc, Stats>::try_insert(const_iterator p, const_reference value) {
+    if (!owns(p) || static_cast<size_type>(p - cbegin()) > size()) {
+        return std::unexpected(BufferError::out_of_range);
     }
-
-    return to_insert;
+    return insert(p, value);
 }
 
-template<typename T, std::size_t scale_factor, typename Alloc>
-CircularBufferExt<T, scale_factor, Alloc>::iterator
-CircularBufferExt<T, scale_factor, Alloc>::insert(CircularBufferExt<T, scale_factor, Alloc>::const_iterator p,
-                                    const std::initializer_list<value_type>& il) {
-    return insert(p, il.begin(), il.end());
+template<typename T, std::size_t scale_factor, typename Alloc, typename Stats>
+std::expected<typename CircularBufferExt<T, scale_factor, Alloc, Stats>::iterator, BufferError>
+CircularBufferExt<T, scale_factor, Alloc, Stats>::try_insert(const_iterator p, value_type&& rv) {
+    if (!owns(p) || static_cast<size_type>(p - cbegin()) > size()) {
+        return std::unexpected(BufferError::out_of_range);
+    }
+    return insert(p, std::move(rv));
 }
 
-
-template<typename T, std::size_t scale_factor, typename Alloc>
-bool CircularBufferExt<T, scale_factor, Alloc>::operator==(const CircularBufferExt& other) const noexcept {
-    return static_cast<const CircularBufferBase<T, Alloc>&>(*this).operator==(
-            static_cast<const CircularBufferBase<T, Alloc>&>(other));
+template<typename T, std::size_t scale_factor, typename Alloc, typename Stats>
+bool CircularBufferExt<T, scale_factor, Alloc, Stats>::operator==(const CircularBufferExt& other) const noexcept {
+    return static_cast<const CircularBufferBase<T, Alloc, Stats>&>(*this).operator==(
+            static_cast<const CircularBufferBase<T, Alloc, Stats>&>(other));
 }
 
-template<typename T, std::size_t scale_factor, typename Alloc>
-bool CircularBufferExt<T, scale_factor, Alloc>::operator!=(const CircularBufferExt& other) const noexcept {
-    return static_cast<const CircularBufferBase<T, Alloc>&>(*this).operator!=(
-            static_cast<const CircularBufferBase<T, Alloc>&>(other));
+template<typename T, std::size_t scale_factor, typename Alloc, typename Stats>
+bool CircularBufferExt<T, scale_factor, Alloc, Stats>::operator!=(const CircularBufferExt& other) const noexcept {
+    return static_cast<const CircularBufferBase<T, Alloc, Stats>&>(*this).operator!=(
+            static_cast<const CircularBufferBase<T, Alloc, Stats>&>(other));
 }
 
-template<typename T, std::size_t scale_factor, typename Alloc>
-void swap(CircularBufferExt<T, scale_factor, Alloc>& lhs, CircularBufferExt<T, scale_factor, Alloc>& rhs) {
+template<typename T, std::size_t scale_factor, typename Alloc, typename Stats>
+void swap(CircularBufferExt<T, scale_factor, Alloc, Stats>& lhs, CircularBufferExt<T, scale_factor, Alloc, Stats>& rhs) {
     lhs.swap(rhs);
 }
 
-#undef USING_FIELDS
+namespace pmr {
+
+template<typename T, std::size_t scale_factor = 2, typename Stats = NoBufferStats>
+using CircularBufferExt = ::CircularBufferExt<T, scale_factor, std::pmr::polymorphic_allocator<T>, Stats>;
+
+} // namespace pmr
@@ -0,0 +1,579 @@
+#pragma once
+
+#include "BufferChecks.hpp"
+#include "CircularBufferBase.hpp"
+
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <tuple>
+#include <utility>
+
+// Fixed-capacity ring that stores each field in its own column, sharing one head and size. Pushing into a full
+// buffer overwrites the opposite end, as CircularBuffer does. column<I>() exposes one field as up to two
+// contiguous spans, so scans over a single field touch only that field's memory.
+//
+// Alloc is rebound to each field type for its column. It comes first because Fields is a pack; CircularBufferSoA
+// and pmr::CircularBufferSoA below fix it.
+template<typename Alloc, typename... Fields>
+class BasicCircularBufferSoA {
+public:
+    static_assert(sizeof...(Fields) > 0, "BasicCircularBufferSoA needs at least one field");
+
+    using value_type = std::tuple<Fields...>;
+    using reference = std::tuple<Fields&...>;
+    using const_reference = std::tuple<const Fields&...>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using allocator_type = Alloc;
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+    template<std::size_t I>
+    using field_type = std::tuple_element_t<I, value_type>;
+
+    template<bool Const>
+    class Iterator;
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    explicit BasicCircularBufferSoA(size_type capacity, const Alloc& allocator = Alloc());
+
+    BasicCircularBufferSoA(const BasicCircularBufferSoA&) = delete;
+
+    BasicCircularBufferSoA& operator=(const BasicCircularBufferSoA&) = delete;
+
+    BasicCircularBufferSoA(BasicCircularBufferSoA&& other) noexcept;
+
+    BasicCircularBufferSoA& operator=(BasicCircularBufferSoA&& other) noexcept(
+            AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value);
+
+    ~BasicCircularBufferSoA();
+
+    // As with the standard containers, allocators that don't propagate on swap must compare equal.
+    void swap(BasicCircularBufferSoA& other) noexcept;
+
+    // One argument per field; each column element is constructed from its argument.
+    template<typename... Args>
+    requires (sizeof...(Args) == sizeof...(Fields))
+    void push_back(Args&& ... args);
+
+    template<typename... Args>
+    requires (sizeof...(Args) == sizeof...(Fields))
+    void push_front(Args&& ... args);
+
+    value_type pop_back();
+
+    value_type pop_front();
+
+    reference operator[](size_type i) noexcept;
+
+    const_reference operator[](size_type i) const noexcept;
+
+    reference front();
+
+    const_reference front() const;
+
+    reference back();
+
+    const_reference back() const;
+
+    template<std::size_t I>
+    RingRegions<field_type<I>> column() noexcept;
+
+    template<std::size_t I>
+    RingRegions<const field_type<I>> column() const noexcept;
+
+    iterator begin() noexcept;
+
+    iterator end() noexcept;
+
+    const_iterator begin() const noexcept;
+
+    const_iterator end() const noexcept;
+
+    const_iterator cbegin() const noexcept;
+
+    const_iterator cend() const noexcept;
+
+    size_type size() const noexcept;
+
+    size_type capacity() const noexcept;
+
+    bool empty() const noexcept;
+
+    void clear() noexcept;
+
+    allocator_type get_allocator() const noexcept;
+
+private:
+    using Indices = std::index_sequence_for<Fields...>;
+
+    template<typename Field>
+    using ColumnAlloc = typename AllocTraits::template rebind_alloc<Field>;
+
+    template<typename Field>
+    using ColumnTraits = typename AllocTraits::template rebind_traits<Field>;
+
+    template<typename Field>
+    Field* allocate_column(size_type capacity);
+
+    template<typename Field>
+    void deallocate_column(Field* column, size_type capacity) noexcept;
+
+    template<typename Field, typename Arg>
+    void construct_field(Field* p, Arg&& arg);
+
+    template<typename Field>
+    void destroy_field(Field* p) noexcept;
+
+    void allocate_columns(size_type capacity);
+
+    void deallocate_columns() noexcept;
+
+    size_type slot(size_type i) const noexcept;
+
+    // Constructs (or assigns, if the slot is live) every column at physical index s from the matching argument.
+    // If a field's constructor throws the row is left as it was; on a live slot that relies on the fields' move
+    // assignment not throwing.
+    template<typename... Args>
+    void put(size_type s, bool live, Args&& ... args);
+
+    value_type take(size_type s);
+
+    void destroy(size_type s) noexcept;
+
+    [[no_unique_address]] Alloc allocator_;
+    std::tuple<Fields* ...> columns_;
+    size_type capacity_;
+    size_type head_ = 0;
+    size_type size_ = 0;
+};
+
+template<typename Alloc, typename... Fields>
+template<bool Const>
+class BasicCircularBufferSoA<Alloc, Fields...>::Iterator {
+public:
+    using Buffer = std::conditional_t<Const, const BasicCircularBufferSoA, BasicCircularBufferSoA>;
+    using iterator_concept = std::random_access_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = BasicCircularBufferSoA::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::conditional_t<Const, BasicCircularBufferSoA::const_reference, BasicCircularBufferSoA::reference>;
+    using pointer = void;
+
+    Iterator() = default;
+
+    Iterator(Buffer* buffer, size_type index) noexcept : buffer_(buffer), index_(index) {}
+
+    operator Iterator<true>() const noexcept requires (!Const) {
+        return Iterator<true>(buffer_, index_);
+    }
+
+    reference operator*() const noexcept {
+        return (*buffer_)[index_];
+    }
+
+    reference operator[](difference_type n) const noexcept {
+        return (*buffer_)[index_ + n];
+    }
+
+    Iterator& operator++() noexcept {
+        ++index_;
+        return *this;
+    }
+
+    Iterator operator++(int) noexcept {
+        Iterator copy = *this;
+        ++index_;
+        return copy;
+    }
+
+    Iterator& operator--() noexcept {
+        --index_;
+        return *this;
+    }
+
+    Iterator operator--(int) noexcept {
+        Iterator copy = *this;
+        --index_;
+        return copy;
+    }
+
+    Iterator& operator+=(difference_type n) noexcept {
+        index_ += n;
+        return *this;
+    }
+
+    Iterator& operator-=(difference_type n) noexcept {
+        index_ -= n;
+        return *this;
+    }
+
+    friend Iterator operator+(Iterator it, difference_type n) noexcept {
+        return it += n;
+    }
+
+    friend Iterator operator+(difference_type n, Iterator it) noexcept {
+        return it += n;
+    }
+
+    friend Iterator operator-(Iterator it, difference_type n) noexcept {
+        return it -= n;
+    }
+
+    friend difference_type operator-(const Iterator& lhs, const Iterator& rhs) noexcept {
+        return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+    }
+
+    bool operator==(const Iterator& other) const noexcept {
+        return index_ == other.index_;
+    }
+
+    std::strong_ordering operator<=>(const Iterator& other) const noexcept {
+        return index_ <=> other.index_;
+    }
+
+private:
+    Buffer* buffer_ = nullptr;
+    size_type index_ = 0;
+};
+
+template<typename Alloc, typename... Fields>
+BasicCircularBufferSoA<Alloc, Fields...>::BasicCircularBufferSoA(size_type capacity, const Alloc& allocator)
+        : allocator_(allocator), capacity_(capacity) {
+    allocate_columns(capacity);
+}
+
+template<typename Alloc, typename... Fields>
+BasicCircularBufferSoA<Alloc, Fields...>::BasicCircularBufferSoA(BasicCircularBufferSoA&& other) noexcept
+        : allocator_(std::move(other.allocator_)),
+          columns_(other.columns_),
+          capacity_(other.capacity_),
+          head_(other.head_),
+          size_(other.size_) {
+    other.columns_ = {};
+    other.capacity_ = other.head_ = other.size_ = 0;
+}
+
+template<typename Alloc, typename... Fields>
+BasicCircularBufferSoA<Alloc, Fields...>& BasicCircularBufferSoA<Alloc, Fields...>::operator=(
+        BasicCircularBufferSoA&& other) noexcept(AllocTraits::propagate_on_container_move_assignment::value ||
+                                                 AllocTraits::is_always_equal::value) {
+    if (this == &other) {
+        return *this;
+    }
+    clear();
+    if constexpr (!AllocTraits::propagate_on_container_move_assignment::value) {
+        if (allocator_ != other.allocator_) {
+            // Our allocator can't free other's columns, so the rows move over one by one.
+            if (capacity_ != other.capacity_) {
+                deallocate_columns();
+                capacity_ = 0;
+                allocate_columns(other.capacity_);
+                capacity_ = other.capacity_;
+            }
+            for (size_type i = 0; i < other.size_; ++i) {
+                const size_type from = other.slot(i);
+                std::apply([&](Fields* ... columns) { put(i, false, std::move(columns[from])...); }, other.columns_);
+                ++size_;
+            }
+            other.clear();
+            return *this;
+        }
+    }
+    deallocate_columns();
+    if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+        allocator_ = std::move(other.allocator_);
+    }
+    columns_ = std::exchange(other.columns_, {});
+    capacity_ = std::exchange(other.capacity_, 0);
+    head_ = std::exchange(other.head_, 0);
+    size_ = std::exchange(other.size_, 0);
+    return *this;
+}
+
+template<typename Alloc, typename... Fields>
+BasicCircularBufferSoA<Alloc, Fields...>::~BasicCircularBufferSoA() {
+    clear();
+    deallocate_columns();
+}
+
+template<typename Alloc, typename... Fields>
+template<typename Field>
+Field* BasicCircularBufferSoA<Alloc, Fields...>::allocate_column(size_type capacity) {
+    ColumnAlloc<Field> allocator(allocator_);
+    return ColumnTraits<Field>::allocate(allocator, capacity);
+}
+
+template<typename Alloc, typename... Fields>
+template<typename Field>
+void BasicCircularBufferSoA<Alloc, Fields...>::deallocate_column(Field* column, size_type capacity) noexcept {
+    ColumnAlloc<Field> allocator(allocator_);
+    ColumnTraits<Field>::deallocate(allocator, column, capacity);
+}
+
+template<typename Alloc, typename... Fields>
+template<typename Field, typename Arg>
+void BasicCircularBufferSoA<Alloc, Fields...>::construct_field(Field* p, Arg&& arg) {
+    ColumnAlloc<Field> allocator(allocator_);
+    ColumnTraits<Field>::construct(allocator, p, std::forward<Arg>(arg));
+}
+
+template<typename Alloc, typename... Fields>
+template<typename Field>
+void BasicCircularBufferSoA<Alloc, Fields...>::destroy_field(Field* p) noexcept {
+    ColumnAlloc<Field> allocator(allocator_);
+    ColumnTraits<Field>::destroy(allocator, p);
+}
+
+template<typename Alloc, typename... Fields>
+void BasicCircularBufferSoA<Alloc, Fields...>::allocate_columns(size_type capacity) {
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        columns_ = {};
+        try {
+            ((std::get<I>(columns_) = allocate_column<Fields>(capacity)), ...);
+        } catch (...) {
+            ((std::get<I>(columns_) != nullptr ? deallocate_column(std::get<I>(columns_), capacity) : void()), ...);
+            columns_ = {};
+            throw;
+        }
+    }(Indices{});
+}
+
+template<typename Alloc, typename... Fields>
+void BasicCircularBufferSoA<Alloc, Fields...>::deallocate_columns() noexcept {
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        ((std::get<I>(columns_) != nullptr ? deallocate_column(std::get<I>(columns_), capacity_) : void()), ...);
+    }(Indices{});
+    columns_ = {};
+}
+
+template<typename Alloc, typename... Fields>
+void BasicCircularBufferSoA<Alloc, Fields...>::swap(BasicCircularBufferSoA& other) noexcept {
+    if constexpr (AllocTraits::propagate_on_container_swap::value) {
+        std::swap(allocator_, other.allocator_);
+    }
+    std::swap(columns_, other.columns_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(head_, other.head_);
+    std::swap(size_, other.size_);
+}
+
+template<typename Alloc, typename... Fields>
+template<typename... Args>
+requires (sizeof...(Args) == sizeof...(Fields))
+void BasicCircularBufferSoA<Alloc, Fields...>::push_back(Args&& ... args) {
+    if (capacity_ == 0) {
+        return;
+    }
+    if (size_ == capacity_) {
+        put(head_, true, std::forward<Args>(args)...);
+        head_ = slot(1);
+        return;
+    }
+    put(slot(size_), false, std::forward<Args>(args)...);
+    ++size_;
+}
+
+template<typename Alloc, typename... Fields>
+template<typename... Args>
+requires (sizeof...(Args) == sizeof...(Fields))
+void BasicCircularBufferSoA<Alloc, Fields...>::push_front(Args&& ... args) {
+    if (capacity_ == 0) {
+        return;
+    }
+    const size_type new_head = slot(capacity_ - 1);
+    put(new_head, size_ == capacity_, std::forward<Args>(args)...);
+    head_ = new_head;
+    if (size_ < capacity_) {
+        ++size_;
+    }
+}
+
+template<typename Alloc, typename... Fields>
+BasicCircularBufferSoA<Alloc, Fields...>::value_type BasicCircularBufferSoA<Alloc, Fields...>::pop_back() {
+    CIRCULAR_BUFFER_CHECK(!empty(), "Trying to pop from empty buffer");
+    --size_;
+    return take(slot(size_));
+}
+
+template<typename Alloc, typename... Fields>
+BasicCircularBufferSoA<Alloc, Fields...>::value_type BasicCircularBufferSoA<Alloc, Fields...>::pop_front() {
+    CIRCULAR_BUFFER_CHECK(!empty(), "Trying to pop from empty buffer");
+    const size_type s = head_;
+    head_ = slot(1);
+    --size_;
+    return take(s);
+}
+
+template<typename Alloc, typename... Fields>
+BasicCircularBufferSoA<Alloc, Fields...>::reference BasicCircularBufferSoA<Alloc, Fields...>::operator[](size_type i) noexcept {
+    const size_type s = slot(i);
+    return std::apply([s](Fields* ... columns) { return reference(columns[s]...); }, columns_);
+}
+
+template<typename Alloc, typename... Fields>
+BasicCircularBufferSoA<Alloc, Fields...>::const_reference BasicCircularBufferSoA<Alloc, Fields...>::operator[](size_type i) const noexcept {
+    const size_type s = slot(i);
+    return std::apply([s](Fields* ... columns) { return const_reference(columns[s]...); }, columns_);
+}
+
+template<typename Alloc, typename... Fields>
+BasicCircularBufferSoA<Alloc, Fields...>::reference BasicCircularBufferSoA<Alloc, Fields...>::front() {
+    CIRCULAR_BUFFER_CHECK(!empty(), "Trying to get data from empty buffer");
+    return (*this)[0];
+}
+
+template<typename Alloc, typename... Fields>
+BasicCircularBufferSoA<Alloc, Fields...>::const_reference BasicCircularBufferSoA<Alloc, Fields...>::front() const {
+    CIRCULAR_BUFFER_CHECK(!empty(), "Trying to get data from empty buffer");
+    return (*this)[0];
+}
+
+template<typename Alloc, typename... Fields>
+BasicCircularBufferSoA<Alloc, Fields...>::reference BasicCircularBufferSoA<Alloc, Fields...>::back() {
+    CIRCULAR_BUFFER_CHECK(!empty(), "Trying to get data from empty buffer");
+    return (*this)[size_ - 1];
+}
+
+template<typename Alloc, typename... Fields>
+BasicCircularBufferSoA<Alloc, Fields...>::const_reference BasicCircularBufferSoA<Alloc, Fields...>::back() const {
+    CIRCULAR_BUFFER_CHECK(!empty(), "Trying to get data from empty buffer");
+    return (*this)[size_ - 1];
+}
+
+template<typename Alloc, typename... Fields>
+template<std::size_t I>
+RingRegions<typename BasicCircularBufferSoA<Alloc, Fields...>::template field_type<I>> BasicCircularBufferSoA<Alloc, Fields...>::column() noexcept {
+    auto* data = std::get<I>(columns_);
+    const size_type first = std::min(size_, capacity_ - head_);
+    return {std::span(data + head_, first), std::span(data, size_ - first)};
+}
+
+template<typename Alloc, typename... Fields>
+template<std::size_t I>
+RingRegions<const typename BasicCircularBufferSoA<Alloc, Fields...>::template field_type<I>>
+BasicCircularBufferSoA<Alloc, Fields...>::column() const noexcept {
+    const auto* data = std::get<I>(columns_);
+    const size_type first = std::min(size_, capacity_ - head_);
+    return {std::span(data + head_, first), std::span(data, size_ - first)};
+}
+
+template<typename Alloc, typename... Fields>
+BasicCircularBufferSoA<Alloc, Fields...>::iterator BasicCircularBufferSoA<Alloc, Fields...>::begin() noexcept {
+    return iterator(this, 0);
+}
+
+template<typename Alloc, typename... Fields>
+BasicCircularBufferSoA<Alloc, Fields...>::iterator BasicCircularBufferSoA<Alloc, Fields...>::end() noexcept {
+    return iterator(this, size_);
+}
+
+template<typename Alloc, typename... Fields>
+BasicCircularBufferSoA<Alloc, Fields...>::const_iterator BasicCircularBufferSoA<Alloc, Fields...>::begin() const noexcept {
+    return const_iterator(this, 0);
+}
+
+template<typename Alloc, typename... Fields>
+BasicCircularBufferSoA<Alloc, Fields...>::const_iterator BasicCircularBufferSoA<Alloc, Fields...>::end() const noexcept {
+    return const_iterator(this, size_);
+}
+
+template<typename Alloc, typename... Fields>
+BasicCircularBufferSoA<Alloc, Fields...>::const_iterator BasicCircularBufferSoA<Alloc, Fields...>::cbegin() const noexcept {
+    return begin();
+}
+
+template<typename Alloc, typename... Fields>
+BasicCircularBufferSoA<Alloc, Fields...>::const_iterator BasicCircularBufferSoA<Alloc, Fields...>::cend() const noexcept {
+    return end();
+}
+
+template<typename Alloc, typename... Fields>
+BasicCircularBufferSoA<Alloc, Fields...>::size_type BasicCircularBufferSoA<Alloc, Fields...>::size() const noexcept {
+    return size_;
+}
+
+template<typename Alloc, typename... Fields>
+BasicCircularBufferSoA<Alloc, Fields...>::size_type BasicCircularBufferSoA<Alloc, Fields...>::capacity() const noexcept {
+    return capacity_;
+}
+
+template<typename Alloc, typename... Fields>
+bool BasicCircularBufferSoA<Alloc, Fields...>::empty() const noexcept {
+    return size_ == 0;
+}
+
+template<typename Alloc, typename... Fields>
+void BasicCircularBufferSoA<Alloc, Fields...>::clear() noexcept {
+    for (size_type i = 0; i < size_; ++i) {
+        destroy(slot(i));
+    }
+    head_ = 0;
+    size_ = 0;
+}
+
+template<typename Alloc, typename... Fields>
+BasicCircularBufferSoA<Alloc, Fields...>::allocator_type BasicCircularBufferSoA<Alloc, Fields...>::get_allocator() const noexcept {
+    return allocator_;
+}
+
+template<typename Alloc, typename... Fields>
+BasicCircularBufferSoA<Alloc, Fields...>::size_type BasicCircularBufferSoA<Alloc, Fields...>::slot(size_type i) const noexcept {
+    const size_type s = head_ + i;
+    return s >= capacity_ ? s - capacity_ : s;
+}
+
+template<typename Alloc, typename... Fields>
+template<typename... Args>
+void BasicCircularBufferSoA<Alloc, Fields...>::put(size_type s, bool live, Args&& ... args) {
+    if (live) {
+        value_type row(std::forward<Args>(args)...);
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            ((std::get<I>(columns_)[s] = std::move(std::get<I>(row))), ...);
+        }(Indices{});
+        return;
+    }
+    size_type constructed = 0;
+    try {
+        std::apply([&](Fields* ... columns) {
+            ((construct_field(columns + s, std::forward<Args>(args)), ++constructed), ...);
+        }, columns_);
+    } catch (...) {
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            ((I < constructed ? destroy_field(std::get<I>(columns_) + s) : void()), ...);
+        }(Indices{});
+        throw;
+    }
+}
+
+template<typename Alloc, typename... Fields>
+BasicCircularBufferSoA<Alloc, Fields...>::value_type BasicCircularBufferSoA<Alloc, Fields...>::take(size_type s) {
+    value_type result = std::apply([s](Fields* ... columns) { return value_type(std::move(columns[s])...); },
+                                   columns_);
+    destroy(s);
+    return result;
+}
+
+template<typename Alloc, typename... Fields>
+void BasicCircularBufferSoA<Alloc, Fields...>::destroy(size_type s) noexcept {
+    std::apply([this, s](Fields* ... columns) { (destroy_field(columns + s), ...); }, columns_);
+}
+
+template<typename Alloc, typename... Fields>
+void swap(BasicCircularBufferSoA<Alloc, Fields...>& lhs, BasicCircularBufferSoA<Alloc, Fields...>& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+template<typename... Fields>
+using CircularBufferSoA = BasicCircularBufferSoA<std::allocator<std::byte>, Fields...>;
+
+namespace pmr {
+
+template<typename... Fields>
+using CircularBufferSoA = ::BasicCircularBufferSoA<std::pmr::polymorphic_allocator<std::byte>, Fields...>;
+
+} // namespace pmr
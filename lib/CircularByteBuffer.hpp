@@ -0,0 +1,145 @@
+#pragma once
+
+#include "CircularBufferBase.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+
+#include <sys/types.h>
+#include <sys/uio.h>
+
+template<typename Alloc = std::allocator<std::byte>>
+class CircularByteBuffer : protected CircularBufferBase<std::byte, Alloc> {
+    using Base = CircularBufferBase<std::byte, Alloc>;
+
+public:
+    using typename Base::allocator_type;
+    using typename Base::AllocTraits;
+    using typename Base::iterator;
+    using typename Base::const_iterator;
+    using typename Base::value_type;
+    using typename Base::size_type;
+    using Base::begin;
+    using Base::end;
+    using Base::cbegin;
+    using Base::cend;
+    using Base::size;
+    using Base::capacity;
+    using Base::empty;
+    using Base::reserve;
+    using Base::clear;
+    using Base::prepare;
+    using Base::commit;
+    using Base::peek;
+    using Base::consume;
+    using Base::get_allocator;
+
+    explicit CircularByteBuffer(size_type n, const Alloc& allocator = Alloc()) : Base(n, allocator) {}
+
+    CircularByteBuffer(const CircularByteBuffer& other) : Base(other) {}
+
+    CircularByteBuffer(CircularByteBuffer&& other) noexcept: Base(std::move(other)) {}
+
+    ~CircularByteBuffer() {
+        if (buff_start_ != nullptr) {
+            clear();
+            AllocTraits::deallocate(allocator_, buff_start_, capacity() + 1);
+        }
+    }
+
+    CircularByteBuffer& operator=(const CircularByteBuffer& other) {
+        Base::operator=(other);
+        return *this;
+    }
+
+    CircularByteBuffer& operator=(CircularByteBuffer&& other) noexcept(AllocTraits::propagate_on_container_move_assignment::value ||
+                                                         AllocTraits::is_always_equal::value) {
+        Base::operator=(std::move(other));
+        return *this;
+    }
+
+    // Copies as many bytes as fit, returns how many were taken.
+    size_type append(std::span<const std::byte> data);
+
+    // Moves up to out.size() bytes from the front into out, returns how many were read.
+    size_type read(std::span<std::byte> out);
+
+    // Single readv() into the free space. Returns the readv() result, so 0 means end of file; on success the bytes
+    // are committed. A full buffer doesn't call readv() and returns -1 with errno set to ENOBUFS.
+    ssize_t read_from(int fd);
+
+    // Single writev() of the stored bytes. Returns the writev() result; on success the bytes are consumed. An
+    // empty buffer doesn't call writev() and returns -1 with errno set to ENODATA.
+    ssize_t write_to(int fd);
+
+protected:
+    using Base::buff_start_;
+    using Base::allocator_;
+
+private:
+    static int to_iovecs(const RingRegions<std::byte>& regions, iovec* iov) noexcept;
+};
+
+template<typename Alloc>
+CircularByteBuffer<Alloc>::size_type CircularByteBuffer<Alloc>::append(std::span<const std::byte> data) {
+    auto regions = prepare(data.size());
+    if (!regions.first.empty()) {
+        std::memcpy(regions.first.data(), data.data(), regions.first.size());
+    }
+    if (!regions.second.empty()) {
+        std::memcpy(regions.second.data(), data.data() + regions.first.size(), regions.second.size());
+    }
+    commit(regions.size());
+    return regions.size();
+}
+
+template<typename Alloc>
+CircularByteBuffer<Alloc>::size_type CircularByteBuffer<Alloc>::read(std::span<std::byte> out) {
+    auto regions = peek(out.size());
+    if (!regions.first.empty()) {
+        std::memcpy(out.data(), regions.first.data(), regions.first.size());
+    }
+    if (!regions.second.empty()) {
+        std::memcpy(out.data() + regions.first.size(), regions.second.data(), regions.second.size());
+    }
+    consume(regions.size());
+    return regions.size();
+}
+
+template<typename Alloc>
+int CircularByteBuffer<Alloc>::to_iovecs(const RingRegions<std::byte>& regions, iovec* iov) noexcept {
+    iov[0] = {regions.first.data(), regions.first.size()};
+    iov[1] = {regions.second.data(), regions.second.size()};
+    return regions.second.empty() ? 1 : 2;
+}
+
+template<typename Alloc>
+ssize_t CircularByteBuffer<Alloc>::read_from(int fd) {
+    iovec iov[2];
+    const auto regions = prepare(capacity() - size());
+    if (regions.size() == 0) {
+        errno = ENOBUFS;
+        return -1;
+    }
+    const ssize_t result = ::readv(fd, iov, to_iovecs(regions, iov));
+    if (result > 0) {
+        commit(result);
+    }
+    return result;
+}
+
+template<typename Alloc>
+ssize_t CircularByteBuffer<Alloc>::write_to(int fd) {
+    iovec iov[2];
+    const auto regions = peek(size());
+    if (regions.size() == 0) {
+        errno = ENODATA;
+        return -1;
+    }
+    const ssize_t result = ::writev(fd, iov, to_iovecs(regions, iov));
+    if (result > 0) {
+        consume(result);
+    }
+    return result;
+}
@@ -0,0 +1,267 @@
+#pragma once
+
+#include "BufferChecks.hpp"
+#include "RecordRingBuffer.hpp"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+// Ring of int64 samples (timestamps, counters) compressed in blocks of kBlockSize values. A full block is
+// stored as one RecordRingBuffer record: the first value, the bit width, then the zigzag-encoded deltas
+// bit-packed at that width. When the ring runs out of room whole blocks are evicted from the front. The newest
+// values stay uncompressed until their block fills up.
+template<typename Alloc = std::allocator<std::byte>>
+class CompressedSeriesBuffer {
+public:
+    using size_type = std::size_t;
+    using value_type = std::int64_t;
+
+    static constexpr size_type kBlockSize = 128;
+
+    // capacity_bytes is the compressed storage; it must hold at least one incompressible block.
+    explicit CompressedSeriesBuffer(size_type capacity_bytes, const Alloc& allocator = Alloc());
+
+    void push_back(value_type value);
+
+    // Calls f(std::span<const value_type>) once per block, oldest first, the open block included.
+    template<typename F>
+    void for_each_block(F&& f) const;
+
+    // Calls f(value) for every stored value, oldest first.
+    template<typename F>
+    void for_each(F&& f) const;
+
+    // Decodes everything into out, which must have room for size() values.
+    void copy_to(value_type* out) const;
+
+    value_type front() const;
+
+    value_type back() const;
+
+    size_type size() const noexcept;
+
+    bool empty() const noexcept;
+
+    // Values dropped with evicted blocks since construction or the last clear().
+    size_type evicted() const noexcept;
+
+    // Bytes taken by the sealed blocks, record headers included.
+    size_type compressed_bytes() const noexcept;
+
+    size_type capacity_bytes() const noexcept;
+
+    void clear() noexcept;
+
+    // Worst-case encoded size of a block, i.e. when the deltas need all 64 bits.
+    static constexpr size_type max_block_bytes() noexcept;
+
+private:
+    static constexpr size_type kHeaderBytes = 2 * sizeof(std::uint64_t);
+
+    static constexpr size_type packed_words(unsigned width) noexcept;
+
+    // Encodes the open block into a new record, evicting old blocks until it fits.
+    void seal();
+
+    template<unsigned Width>
+    static void unpack(const std::uint64_t* words, std::uint64_t* deltas) noexcept;
+
+    static void decode(std::span<const std::byte> record, value_type* out) noexcept;
+
+    RecordRingBuffer<Alloc> blocks_;
+    value_type open_[kBlockSize];
+    size_type open_size_ = 0;
+    size_type evicted_ = 0;
+};
+
+
+template<typename Alloc>
+constexpr CompressedSeriesBuffer<Alloc>::size_type CompressedSeriesBuffer<Alloc>::packed_words(unsigned width) noexcept {
+    return ((kBlockSize - 1) * width + 63) / 64;
+}
+
+template<typename Alloc>
+constexpr CompressedSeriesBuffer<Alloc>::size_type CompressedSeriesBuffer<Alloc>::max_block_bytes() noexcept {
+    return kHeaderBytes + packed_words(64) * sizeof(std::uint64_t);
+}
+
+template<typename Alloc>
+CompressedSeriesBuffer<Alloc>::CompressedSeriesBuffer(size_type capacity_bytes, const Alloc& allocator)
+        : blocks_(capacity_bytes, allocator) {
+    if (blocks_.capacity() < RecordRingBuffer<Alloc>::record_footprint(max_block_bytes())) {
+        throw std::length_error("CompressedSeriesBuffer capacity is below one block");
+    }
+}
+
+template<typename Alloc>
+void CompressedSeriesBuffer<Alloc>::push_back(value_type value) {
+    open_[open_size_++] = value;
+    if (open_size_ == kBlockSize) {
+        seal();
+    }
+}
+
+template<typename Alloc>
+void CompressedSeriesBuffer<Alloc>::seal() {
+    // Deltas are taken modulo 2^64 so that any pair of values round-trips.
+    std::uint64_t zigzag[kBlockSize - 1];
+    std::uint64_t bits = 0;
+    for (size_type i = 0; i < kBlockSize - 1; ++i) {
+        const auto delta = static_cast<std::uint64_t>(open_[i + 1]) - static_cast<std::uint64_t>(open_[i]);
+        zigzag[i] = (delta << 1) ^ static_cast<std::uint64_t>(static_cast<std::int64_t>(delta) >> 63);
+        bits |= zigzag[i];
+    }
+    const auto width = static_cast<unsigned>(std::bit_width(bits));
+    const size_type len = kHeaderBytes + packed_words(width) * sizeof(std::uint64_t);
+
+    auto payload = blocks_.reserve(len);
+    while (payload.size() != len) {
+        blocks_.pop_record();
+        evicted_ += kBlockSize;
+        payload = blocks_.reserve(len);
+    }
+
+    std::uint64_t words[kBlockSize] = {};
+    for (size_type i = 0; width != 0 && i < kBlockSize - 1; ++i) {
+        const size_type offset = i * width;
+        const unsigned shift = offset % 64;
+        words[offset / 64] |= zigzag[i] << shift;
+        if (shift + width > 64) {
+            words[offset / 64 + 1] |= zigzag[i] >> (64 - shift);
+        }
+    }
+    const std::uint64_t header[2] = {static_cast<std::uint64_t>(open_[0]), width};
+    std::memcpy(payload.data(), header, kHeaderBytes);
+    std::memcpy(payload.data() + kHeaderBytes, words, packed_words(width) * sizeof(std::uint64_t));
+    blocks_.commit(len);
+    open_size_ = 0;
+}
+
+template<typename Alloc>
+template<unsigned Width>
+void CompressedSeriesBuffer<Alloc>::unpack(const std::uint64_t* words, std::uint64_t* deltas) noexcept {
+    // With the width a constant every shift and word index folds, and the loop has no branches.
+    constexpr std::uint64_t mask = (Width == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << Width) - 1);
+    for (size_type i = 0; i < kBlockSize - 1; ++i) {
+        const size_type offset = i * Width;
+        const unsigned shift = offset % 64;
+        const std::uint64_t low = words[offset / 64] >> shift;
+        const std::uint64_t high = (words[offset / 64 + 1] << 1) << (63 - shift);
+        deltas[i] = (low | high) & mask;
+    }
+}
+
+template<typename Alloc>
+void CompressedSeriesBuffer<Alloc>::decode(std::span<const std::byte> record, value_type* out) noexcept {
+    using Unpacker = void (*)(const std::uint64_t*, std::uint64_t*) noexcept;
+    static constexpr auto unpackers = []<unsigned... Widths>(std::integer_sequence<unsigned, Widths...>) {
+        return std::array<Unpacker, sizeof...(Widths)>{&unpack<Widths>...};
+    }(std::make_integer_sequence<unsigned, 65>());
+
+    std::uint64_t header[2];
+    std::memcpy(header, record.data(), kHeaderBytes);
+    // One spare zero word lets every value read two neighbouring words without a bounds check.
+    std::uint64_t words[kBlockSize] = {};
+    std::memcpy(words, record.data() + kHeaderBytes, record.size() - kHeaderBytes);
+
+    std::uint64_t deltas[kBlockSize - 1];
+    unpackers[header[1]](words, deltas);
+    for (size_type i = 0; i < kBlockSize - 1; ++i) {
+        deltas[i] = (deltas[i] >> 1) ^ (~(deltas[i] & 1) + 1);
+    }
+    auto current = header[0];
+    out[0] = static_cast<value_type>(current);
+    for (size_type i = 0; i < kBlockSize - 1; ++i) {
+        current += deltas[i];
+        out[i + 1] = static_cast<value_type>(current);
+    }
+}
+
+template<typename Alloc>
+template<typename F>
+void CompressedSeriesBuffer<Alloc>::for_each_block(F&& f) const {
+    value_type decoded[kBlockSize];
+    blocks_.for_each_record([&](std::span<const std::byte> record) {
+        decode(record, decoded);
+        f(std::span<const value_type>(decoded, kBlockSize));
+    });
+    if (open_size_ != 0) {
+        f(std::span<const value_type>(open_, open_size_));
+    }
+}
+
+template<typename Alloc>
+template<typename F>
+void CompressedSeriesBuffer<Alloc>::for_each(F&& f) const {
+    for_each_block([&f](std::span<const value_type> block) {
+        for (const value_type value: block) {
+            f(value);
+        }
+    });
+}
+
+template<typename Alloc>
+void CompressedSeriesBuffer<Alloc>::copy_to(value_type* out) const {
+    blocks_.for_each_record([&out](std::span<const std::byte> record) {
+        decode(record, out);
+        out += kBlockSize;
+    });
+    std::memcpy(out, open_, open_size_ * sizeof(value_type));
+}
+
+template<typename Alloc>
+CompressedSeriesBuffer<Alloc>::value_type CompressedSeriesBuffer<Alloc>::front() const {
+    CIRCULAR_BUFFER_CHECK(!empty(), "Trying to get an element from an empty buffer");
+    if (blocks_.empty()) {
+        return open_[0];
+    }
+    value_type first;
+    std::memcpy(&first, blocks_.front_record().data(), sizeof(first));
+    return first;
+}
+
+template<typename Alloc>
+CompressedSeriesBuffer<Alloc>::value_type CompressedSeriesBuffer<Alloc>::back() const {
+    CIRCULAR_BUFFER_CHECK(!empty(), "Trying to get an element from an empty buffer");
+    // A sealed block keeps its values in open_ until the next push overwrites them.
+    return open_[(open_size_ + kBlockSize - 1) % kBlockSize];
+}
+
+template<typename Alloc>
+CompressedSeriesBuffer<Alloc>::size_type CompressedSeriesBuffer<Alloc>::size() const noexcept {
+    return blocks_.records() * kBlockSize + open_size_;
+}
+
+template<typename Alloc>
+bool CompressedSeriesBuffer<Alloc>::empty() const noexcept {
+    return size() == 0;
+}
+
+template<typename Alloc>
+CompressedSeriesBuffer<Alloc>::size_type CompressedSeriesBuffer<Alloc>::evicted() const noexcept {
+    return evicted_;
+}
+
+template<typename Alloc>
+CompressedSeriesBuffer<Alloc>::size_type CompressedSeriesBuffer<Alloc>::compressed_bytes() const noexcept {
+    return blocks_.bytes_used();
+}
+
+template<typename Alloc>
+CompressedSeriesBuffer<Alloc>::size_type CompressedSeriesBuffer<Alloc>::capacity_bytes() const noexcept {
+    return blocks_.capacity();
+}
+
+template<typename Alloc>
+void CompressedSeriesBuffer<Alloc>::clear() noexcept {
+    blocks_.clear();
+    open_size_ = 0;
+    evicted_ = 0;
+}
@@ -0,0 +1,284 @@
+#pragma once
+
+#include "BufferChecks.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+// Wait strategies: wait(ready) returns once ready() holds, notify() is called after every cursor move.
+
+// Lowest latency; burns a core per waiting thread.
+struct BusySpinWait {
+    template<typename Ready>
+    void wait(Ready&& ready) noexcept {
+        while (!ready()) {
+        }
+    }
+
+    void notify() noexcept {}
+};
+
+// Spins for a while, then gives the core away between checks.
+struct YieldingWait {
+    static constexpr int kSpins = 100;
+
+    template<typename Ready>
+    void wait(Ready&& ready) noexcept {
+        for (int spins = 0; !ready(); ++spins) {
+            if (spins >= kSpins) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void notify() noexcept {}
+};
+
+// Sleeps on a condition variable; every notify() takes the mutex, so this is the slowest for the publisher.
+struct BlockingWait {
+    template<typename Ready>
+    void wait(Ready&& ready) {
+        if (ready()) {
+            return;
+        }
+        std::unique_lock lock(mutex_);
+        wake_.wait(lock, ready);
+    }
+
+    void notify() {
+        { std::lock_guard lock(mutex_); }
+        wake_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable wake_;
+};
+
+// Single-producer multicast ring in the style of the LMAX Disruptor. The producer claims preallocated slots,
+// fills them in place and publishes them; every consumer walks the same slots with its own cursor. A consumer
+// may be declared to run after others (a bitmask of consumer ids), and the producer never laps the slowest
+// consumer. Sequences count events from 0; a cursor is the sequence of the next event to process.
+template<typename T, typename Wait = YieldingWait>
+class DisruptorRing {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using sequence_type = std::uint64_t;
+    using consumer_id = std::size_t;
+
+    static constexpr consumer_id kMaxConsumers = 64;
+
+    // capacity is rounded up to a power of two.
+    explicit DisruptorRing(size_type capacity);
+
+    DisruptorRing(const DisruptorRing&) = delete;
+
+    DisruptorRing& operator=(const DisruptorRing&) = delete;
+
+    // Registers a consumer that only sees an event after every consumer in the `after` mask (bit i = id i) has
+    // released it. Must happen before the first claim.
+    consumer_id add_consumer(std::uint64_t after = 0);
+
+    // Producer side; one thread. Waits until n slots are free and returns the first claimed sequence.
+    sequence_type claim(size_type n = 1);
+
+    std::optional<sequence_type> try_claim(size_type n = 1) noexcept;
+
+    // Makes every claimed sequence below end visible to the consumers.
+    void publish(sequence_type end);
+
+    // Consumer side; one thread per consumer. Waits until `next` is available and returns the end of the
+    // available run, which may be far past next.
+    sequence_type wait_for(consumer_id consumer, sequence_type next);
+
+    // End of the run currently available to consumer, without waiting.
+    sequence_type available(consumer_id consumer) const noexcept;
+
+    // Marks every event below end as done by consumer: dependent consumers and the producer may move past them.
+    void release(consumer_id consumer, sequence_type end);
+
+    // Calls f(slot, sequence) for every available event and releases them with one cursor update. Never
+    // waits; returns the number of events handled.
+    template<typename F>
+    size_type poll(consumer_id consumer, F&& f);
+
+    T& operator[](sequence_type sequence) noexcept;
+
+    const T& operator[](sequence_type sequence) const noexcept;
+
+    sequence_type cursor(consumer_id consumer) const noexcept;
+
+    sequence_type published() const noexcept;
+
+    size_type consumers() const noexcept;
+
+    size_type capacity() const noexcept;
+
+private:
+    struct alignas(64) Cursor {
+        std::atomic<sequence_type> value{0};
+        std::uint64_t after = 0;
+    };
+
+    sequence_type slowest_consumer() const noexcept;
+
+    std::unique_ptr<T[]> slots_;
+    size_type mask_;
+    std::unique_ptr<Cursor[]> consumers_;
+    size_type consumer_count_ = 0;
+    [[no_unique_address]] Wait wait_;
+
+    alignas(64) std::atomic<sequence_type> published_{0};
+    // Producer-private: next sequence to claim and the last known position of the slowest consumer.
+    alignas(64) sequence_type claimed_ = 0;
+    sequence_type gate_ = 0;
+};
+
+
+template<typename T, typename Wait>
+DisruptorRing<T, Wait>::DisruptorRing(size_type capacity)
+        : slots_(std::make_unique<T[]>(std::bit_ceil(std::max<size_type>(capacity, 1)))),
+          mask_(std::bit_ceil(std::max<size_type>(capacity, 1)) - 1),
+          consumers_(std::make_unique<Cursor[]>(kMaxConsumers)) {}
+
+template<typename T, typename Wait>
+DisruptorRing<T, Wait>::consumer_id DisruptorRing<T, Wait>::add_consumer(std::uint64_t after) {
+    if (consumer_count_ == kMaxConsumers) {
+        throw std::length_error("DisruptorRing has no free consumer slots");
+    }
+    CIRCULAR_BUFFER_CHECK(claimed_ == 0, "Consumers must be added before the first claim");
+    CIRCULAR_BUFFER_CHECK(static_cast<size_type>(std::bit_width(after)) <= consumer_count_,
+                          "A consumer can only follow existing consumers");
+    consumers_[consumer_count_].after = after;
+    return consumer_count_++;
+}
+
+template<typename T, typename Wait>
+DisruptorRing<T, Wait>::sequence_type DisruptorRing<T, Wait>::slowest_consumer() const noexcept {
+    sequence_type slowest = claimed_;
+    for (consumer_id i = 0; i < consumer_count_; ++i) {
+        slowest = std::min(slowest, consumers_[i].value.load(std::memory_order_acquire));
+    }
+    return slowest;
+}
+
+template<typename T, typename Wait>
+DisruptorRing<T, Wait>::sequence_type DisruptorRing<T, Wait>::claim(size_type n) {
+    CIRCULAR_BUFFER_CHECK(n <= capacity(), "Trying to claim more slots than the ring has");
+    const sequence_type end = claimed_ + n;
+    if (end - gate_ > capacity()) {
+        wait_.wait([&] {
+            gate_ = slowest_consumer();
+            return end - gate_ <= capacity();
+        });
+    }
+    return std::exchange(claimed_, end);
+}
+
+template<typename T, typename Wait>
+std::optional<typename DisruptorRing<T, Wait>::sequence_type> DisruptorRing<T, Wait>::try_claim(size_type n) noexcept {
+    const sequence_type end = claimed_ + n;
+    if (n > capacity()) {
+        return std::nullopt;
+    }
+    if (end - gate_ > capacity()) {
+        gate_ = slowest_consumer();
+        if (end - gate_ > capacity()) {
+            return std::nullopt;
+        }
+    }
+    return std::exchange(claimed_, end);
+}
+
+template<typename T, typename Wait>
+void DisruptorRing<T, Wait>::publish(sequence_type end) {
+    CIRCULAR_BUFFER_CHECK(end <= claimed_, "Trying to publish sequences that were not claimed");
+    published_.store(end, std::memory_order_release);
+    wait_.notify();
+}
+
+template<typename T, typename Wait>
+DisruptorRing<T, Wait>::sequence_type DisruptorRing<T, Wait>::available(consumer_id consumer) const noexcept {
+    sequence_type end = published_.load(std::memory_order_acquire);
+    for (std::uint64_t after = consumers_[consumer].after; after != 0; after &= after - 1) {
+        end = std::min(end, consumers_[std::countr_zero(after)].value.load(std::memory_order_acquire));
+    }
+    return end;
+}
+
+template<typename T, typename Wait>
+DisruptorRing<T, Wait>::sequence_type DisruptorRing<T, Wait>::wait_for(consumer_id consumer, sequence_type next) {
+    CIRCULAR_BUFFER_CHECK(consumer < consumer_count_, "Unknown consumer");
+    sequence_type end = available(consumer);
+    if (end <= next) {
+        wait_.wait([&] {
+            end = available(consumer);
+            return end > next;
+        });
+    }
+    return end;
+}
+
+template<typename T, typename Wait>
+void DisruptorRing<T, Wait>::release(consumer_id consumer, sequence_type end) {
+    CIRCULAR_BUFFER_CHECK(consumer < consumer_count_, "Unknown consumer");
+    consumers_[consumer].value.store(end, std::memory_order_release);
+    wait_.notify();
+}
+
+template<typename T, typename Wait>
+template<typename F>
+DisruptorRing<T, Wait>::size_type DisruptorRing<T, Wait>::poll(consumer_id consumer, F&& f) {
+    CIRCULAR_BUFFER_CHECK(consumer < consumer_count_, "Unknown consumer");
+    const sequence_type begin = consumers_[consumer].value.load(std::memory_order_relaxed);
+    const sequence_type end = available(consumer);
+    if (end == begin) {
+        return 0;
+    }
+    for (sequence_type sequence = begin; sequence != end; ++sequence) {
+        f(slots_[sequence & mask_], sequence);
+    }
+    release(consumer, end);
+    return end - begin;
+}
+
+template<typename T, typename Wait>
+T& DisruptorRing<T, Wait>::operator[](sequence_type sequence) noexcept {
+    return slots_[sequence & mask_];
+}
+
+template<typename T, typename Wait>
+const T& DisruptorRing<T, Wait>::operator[](sequence_type sequence) const noexcept {
+    return slots_[sequence & mask_];
+}
+
+template<typename T, typename Wait>
+DisruptorRing<T, Wait>::sequence_type DisruptorRing<T, Wait>::cursor(consumer_id consumer) const noexcept {
+    return consumers_[consumer].value.load(std::memory_order_acquire);
+}
+
+template<typename T, typename Wait>
+DisruptorRing<T, Wait>::sequence_type DisruptorRing<T, Wait>::published() const noexcept {
+    return published_.load(std::memory_order_acquire);
+}
+
+template<typename T, typename Wait>
+DisruptorRing<T, Wait>::size_type DisruptorRing<T, Wait>::consumers() const noexcept {
+    return consumer_count_;
+}
+
+template<typename T, typename Wait>
+DisruptorRing<T, Wait>::size_type DisruptorRing<T, Wait>::capacity() const noexcept {
+    return mask_ + 1;
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+struct HugePageOptions {
+    // Try MAP_HUGETLB first, then fall back to transparent huge pages via madvise(MADV_HUGEPAGE).
+    bool huge_pages = true;
+    // Fault every page in at allocation time instead of on first touch.
+    bool populate = false;
+    // Bind the pages to this NUMA node with mbind(MPOL_BIND); -1 leaves placement to the kernel.
+    int numa_node = -1;
+
+    bool operator==(const HugePageOptions&) const = default;
+};
+
+// Allocator that backs every allocation with its own anonymous mapping. Huge pages, NUMA binding and pre-faulting
+// are best effort: whatever the kernel refuses is skipped and the memory stays usable. Meant for large,
+// long-lived buffers - each allocation costs at least a page and a system call.
+template<typename T>
+class HugePageAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    static constexpr std::size_t kHugePageSize = std::size_t{2} << 20;
+
+    explicit HugePageAllocator(HugePageOptions options = {}) noexcept : options_(options) {}
+
+    template<typename U>
+    HugePageAllocator(const HugePageAllocator<U>& other) noexcept : options_(other.options()) {}
+
+    T* allocate(std::size_t n);
+
+    void deallocate(T* p, std::size_t n) noexcept;
+
+    const HugePageOptions& options() const noexcept {
+        return options_;
+    }
+
+    template<typename U>
+    bool operator==(const HugePageAllocator<U>& other) const noexcept {
+        return options_ == other.options();
+    }
+
+private:
+    static std::size_t round_up(std::size_t bytes, std::size_t alignment) noexcept {
+        return (bytes + alignment - 1) / alignment * alignment;
+    }
+
+    std::size_t mapping_length(std::size_t n) const noexcept;
+
+    void* map_aligned(std::size_t length) const noexcept;
+
+    void bind_and_populate(void* p, std::size_t length, bool populated) const noexcept;
+
+    HugePageOptions options_;
+};
+
+template<typename T>
+std::size_t HugePageAllocator<T>::mapping_length(std::size_t n) const noexcept {
+    const std::size_t bytes = n * sizeof(T);
+    const auto page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    return round_up(bytes == 0 ? 1 : bytes, options_.huge_pages && bytes >= kHugePageSize / 2 ? kHugePageSize : page_size);
+}
+
+template<typename T>
+T* HugePageAllocator<T>::allocate(std::size_t n) {
+    static_assert(alignof(T) <= kHugePageSize, "Alignment beyond a huge page is not supported");
+    if (n > SIZE_MAX / sizeof(T)) {
+        throw std::bad_array_new_length();
+    }
+    const std::size_t length = mapping_length(n);
+    // Pages must be bound before they are faulted in, so MAP_POPULATE is only used without a NUMA node.
+    const int populate = (options_.populate && options_.numa_node < 0 ? MAP_POPULATE : 0);
+
+    void* p = MAP_FAILED;
+    if (options_.huge_pages && length % kHugePageSize == 0) {
+        p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | populate, -1, 0);
+    }
+    bool populated = (p != MAP_FAILED && populate != 0);
+    if (p == MAP_FAILED) {
+        p = map_aligned(length);
+        if (p == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        populated = false;
+    }
+    bind_and_populate(p, length, populated);
+    return static_cast<T*>(p);
+}
+
+template<typename T>
+void HugePageAllocator<T>::deallocate(T* p, std::size_t n) noexcept {
+    munmap(p, mapping_length(n));
+}
+
+// Regular pages, aligned to a huge page boundary when the region spans one so that THP can back it.
+template<typename T>
+void* HugePageAllocator<T>::map_aligned(std::size_t length) const noexcept {
+    if (!options_.huge_pages || length % kHugePageSize != 0) {
+        return mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+    void* raw = mmap(nullptr, length + kHugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return raw;
+    }
+    const auto start = reinterpret_cast<std::uintptr_t>(raw);
+    const std::uintptr_t aligned = round_up(start, kHugePageSize);
+    if (aligned != start) {
+        munmap(raw, aligned - start);
+    }
+    if (const std::size_t tail = kHugePageSize - (aligned - start); tail != 0) {
+        munmap(reinterpret_cast<void*>(aligned + length), tail);
+    }
+    madvise(reinterpret_cast<void*>(aligned), length, MADV_HUGEPAGE);
+    return reinterpret_cast<void*>(aligned);
+}
+
+template<typename T>
+void HugePageAllocator<T>::bind_and_populate(void* p, std::size_t length, bool populated) const noexcept {
+    if (options_.numa_node >= 0) {
+        constexpr unsigned long kMpolBind = 2;
+        constexpr std::size_t kMaxNodes = 1024;
+        unsigned long mask[kMaxNodes / (8 * sizeof(unsigned long))] = {};
+        const auto node = static_cast<std::size_t>(options_.numa_node);
+        if (node < kMaxNodes) {
+            mask[node / (8 * sizeof(unsigned long))] = 1UL << (node % (8 * sizeof(unsigned long)));
+            syscall(SYS_mbind, p, length, kMpolBind, mask, kMaxNodes + 1, 0);
+        }
+    }
+    if (options_.populate && !populated) {
+        const auto page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        auto* bytes = static_cast<volatile unsigned char*>(p);
+        for (std::size_t offset = 0; offset < length; offset += page_size) {
+            bytes[offset] = 0;
+        }
+    }
+}
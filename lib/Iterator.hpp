@@ -1,5 +1,7 @@
 #pragma once
 
+#include "BufferChecks.hpp"
+
 #include <iterator>
 
 #define NOT_EMPTY_BUFFER if (buff_start_ + 1 == buff_end_) {return *this;}
@@ -25,15 +27,15 @@ public:
 
     reference operator*() const noexcept;
 
-    reference operator->() const noexcept;
+    pointer operator->() const noexcept;
 
     reference operator[](std::size_t n) const noexcept;
 
     CommonIterator& operator++() noexcept; // infix
-    CommonIterator operator++(int) const noexcept; // postfix
+    CommonIterator operator++(int) noexcept; // postfix
 
     CommonIterator& operator--() noexcept; // infix
-    CommonIterator operator--(int) const noexcept; // postfix
+    CommonIterator operator--(int) noexcept; // postfix
 
     CommonIterator operator+(int n) const noexcept;
 
@@ -59,6 +61,9 @@ public:
 
 
 private:
+    // Position relative to the first element, which gives the logical order without throwing.
+    difference_type offset() const noexcept;
+
     pointer current_;
     pointer buff_start_;
     pointer buff_end_;
@@ -92,7 +97,7 @@ CommonIterator<T>::CommonIterator(CommonIterator::pointer current,
 
 
 template<typename T>
-CommonIterator<T>::reference CommonIterator<T>::operator->() const noexcept {
+CommonIterator<T>::pointer CommonIterator<T>::operator->() const noexcept {
     return current_;
 }
 
@@ -110,7 +115,7 @@ CommonIterator<T>& CommonIterator<T>::operator++() noexcept { // infix
 }
 
 template<typename T>
-CommonIterator<T> CommonIterator<T>::operator++(int) const noexcept {
+CommonIterator<T> CommonIterator<T>::operator++(int) noexcept {
     NOT_EMPTY_BUFFER;
     const auto old_ptr = current_;
     current_ = (current_ + 1 != buff_end_ ? current_ + 1 : buff_start_);
@@ -126,7 +131,7 @@ CommonIterator<T>& CommonIterator<T>::operator--() noexcept {
 
 
 template<typename T>
-CommonIterator<T> CommonIterator<T>::operator--(int) const noexcept {
+CommonIterator<T> CommonIterator<T>::operator--(int) noexcept {
     NOT_EMPTY_BUFFER;
     const auto old_ptr = current_;
     current_ = (current_ != buff_start_ ? current_ - 1 : buff_end_ - 1);
@@ -191,32 +196,29 @@ CommonIterator<T>& CommonIterator<T>::operator-=(int n) noexcept {
     }
     const auto distance_to_start = std::distance(buff_start_, current_);
     if (n <= distance_to_start) {
-        return CommonIterator(current_ - n, buff_start_, buff_end_, actual_start_, actual_end_);
+        current_ -= n;
+        return *this;
     }
-    return CommonIterator(buff_end_ - (n - distance_to_start) % std::distance(buff_start_, buff_end_), buff_start_,
-                          buff_end_, actual_start_, actual_end_);
+    current_ = buff_end_ - (n - distance_to_start) % std::distance(buff_start_, buff_end_);
+    return *this;
 }
 
 
 template<typename T>
-typename CommonIterator<T>::difference_type
-CommonIterator<T>::operator-(const CommonIterator<T>& other) const {
-    // *this - other
-    if (buff_start_ != other.buff_start_ || buff_end_ != other.buff_end_) {
-        throw std::out_of_range("Iterator is out of bounds");
-    }
+typename CommonIterator<T>::difference_type CommonIterator<T>::offset() const noexcept {
     if (current_ >= actual_start_) {
-        if (other.current_ >= actual_start_) {
-            return std::distance(other.current_, current_);
-        }
-        return -(std::distance(current_, buff_end_) + std::distance(buff_start_, other.current_));
+        return std::distance(actual_start_, current_);
     }
-    // Else
-    if (other.current_ <= actual_end_) {
-        return std::distance(other.current_, current_);
-    }
-    return std::distance(other.current_, buff_end_) + std::distance(buff_start_, current_);
+    return std::distance(actual_start_, buff_end_) + std::distance(buff_start_, current_);
+}
 
+template<typename T>
+typename CommonIterator<T>::difference_type
+CommonIterator<T>::operator-(const CommonIterator<T>& other) const {
+    // *this - other
+    CIRCULAR_BUFFER_CHECK(buff_start_ == other.buff_start_ && buff_end_ == other.buff_end_,
+                          "Iterator is out of bounds");
+    return offset() - other.offset();
 }
 
 template<typename T>
@@ -231,12 +233,12 @@ bool CommonIterator<T>::operator!=(const CommonIterator& other) const noexcept {
 
 template<typename T>
 bool CommonIterator<T>::operator>(const CommonIterator& other) const noexcept {
-    return (this->operator!=(other) && this->operator-(other) > 0);
+    return offset() > other.offset();
 }
 
 template<typename T>
 bool CommonIterator<T>::operator<(const CommonIterator& other) const noexcept {
-    return (this->operator!=(other) && this->operator-(other) < 0);
+    return offset() < other.offset();
 }
 
 template<typename T>
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "BufferStats.hpp"
+
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+// Log-linear (HDR-style) histogram: exact below 2^kSubBucketBits, then 2^(kSubBucketBits - 1) buckets per power
+// of two. percentile() reports the top of a bucket, so it overstates by at most 1/16 = 6.25% of the value. Only
+// the owning thread records; other threads read or merge it lock-free.
+class LatencyHistogram {
+public:
+    static constexpr unsigned kSubBucketBits = 5;
+    static constexpr std::size_t kHalfSubBuckets = std::size_t{1} << (kSubBucketBits - 1);
+    static constexpr std::size_t kBucketCount = (64 - kSubBucketBits) * kHalfSubBuckets + 2 * kHalfSubBuckets;
+
+    LatencyHistogram() = default;
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void record(std::uint64_t value) noexcept {
+        bump(counts_[bucket_of(value)], 1);
+        bump(total_, 1);
+        if (value > max_.load(std::memory_order_relaxed)) {
+            max_.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    // Adds other's samples; safe while other is still recording.
+    void merge(const LatencyHistogram& other) noexcept {
+        std::uint64_t merged = 0;
+        for (std::size_t i = 0; i < kBucketCount; ++i) {
+            const auto count = other.counts_[i].load(std::memory_order_relaxed);
+            counts_[i].fetch_add(count, std::memory_order_relaxed);
+            merged += count;
+        }
+        total_.fetch_add(merged, std::memory_order_relaxed);
+        const auto other_max = other.max();
+        if (other_max > max_.load(std::memory_order_relaxed)) {
+            max_.store(other_max, std::memory_order_relaxed);
+        }
+    }
+
+    void reset() noexcept {
+        for (auto& count : counts_) {
+            count.store(0, std::memory_order_relaxed);
+        }
+        total_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+    std::uint64_t count() const noexcept {
+        return total_.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t max() const noexcept {
+        return max_.load(std::memory_order_relaxed);
+    }
+
+    // Upper bound of the bucket holding the q-quantile, q in [0, 1]; never above max().
+    std::uint64_t percentile(double q) const noexcept {
+        const auto total = count();
+        if (total == 0) {
+            return 0;
+        }
+        auto rank = static_cast<std::uint64_t>(q * static_cast<double>(total) + 0.5);
+        rank = std::max<std::uint64_t>(rank, 1);
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < kBucketCount; ++i) {
+            seen += counts_[i].load(std::memory_order_relaxed);
+            if (seen >= rank) {
+                return std::min(highest_in_bucket(i), max());
+            }
+        }
+        return max();
+    }
+
+    static std::size_t bucket_of(std::uint64_t value) noexcept {
+        if (value < 2 * kHalfSubBuckets) {
+            return value;
+        }
+        const unsigned shift = std::bit_width(value) - kSubBucketBits;
+        return shift * kHalfSubBuckets + (value >> shift);
+    }
+
+    static std::uint64_t lowest_in_bucket(std::size_t bucket) noexcept {
+        if (bucket < 2 * kHalfSubBuckets) {
+            return bucket;
+        }
+        const std::size_t shift = bucket / kHalfSubBuckets - 1;
+        return static_cast<std::uint64_t>(bucket - shift * kHalfSubBuckets) << shift;
+    }
+
+    static std::uint64_t highest_in_bucket(std::size_t bucket) noexcept {
+        if (bucket < 2 * kHalfSubBuckets) {
+            return bucket;
+        }
+        const std::size_t shift = bucket / kHalfSubBuckets - 1;
+        return lowest_in_bucket(bucket) + ((std::uint64_t{1} << shift) - 1);
+    }
+
+private:
+    static void bump(std::atomic<std::uint64_t>& counter, std::uint64_t n) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    std::atomic<std::uint64_t> counts_[kBucketCount] = {};
+    std::atomic<std::uint64_t> total_{0};
+    std::atomic<std::uint64_t> max_{0};
+};
+
+// Stats policy that times every traced operation into a per-operation histogram (nanoseconds).
+// StatsBase keeps the counters of another policy, e.g. LatencyTracer<BufferStats>.
+template<typename StatsBase = NoBufferStats, typename Clock = std::chrono::steady_clock>
+class LatencyTracer : public StatsBase {
+public:
+    class Scope {
+    public:
+        Scope(LatencyTracer& tracer, BufferOperation operation) noexcept
+                : tracer_(tracer), operation_(operation), start_(Clock::now()) {}
+
+        Scope(const Scope&) = delete;
+
+        Scope& operator=(const Scope&) = delete;
+
+        ~Scope() {
+            const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start_);
+            tracer_.histogram(operation_).record(elapsed.count() < 0 ? 0 : elapsed.count());
+        }
+
+    private:
+        LatencyTracer& tracer_;
+        BufferOperation operation_;
+        typename Clock::time_point start_;
+    };
+
+    Scope scope(BufferOperation operation) noexcept {
+        return Scope(*this, operation);
+    }
+
+    LatencyHistogram& histogram(BufferOperation operation) noexcept {
+        return histograms_[static_cast<std::size_t>(operation)];
+    }
+
+    const LatencyHistogram& histogram(BufferOperation operation) const noexcept {
+        return histograms_[static_cast<std::size_t>(operation)];
+    }
+
+    // Folds in the histograms of a tracer owned by another thread.
+    void merge(const LatencyTracer& other) noexcept {
+        for (std::size_t i = 0; i < kBufferOperationCount; ++i) {
+            histograms_[i].merge(other.histograms_[i]);
+        }
+    }
+
+    // One line per operation that has samples: count, p50, p99, p99.9 and max in nanoseconds.
+    void report(std::ostream& out) const {
+        for (std::size_t i = 0; i < kBufferOperationCount; ++i) {
+            const auto& h = histograms_[i];
+            if (h.count() == 0) {
+                continue;
+            }
+            out << to_string(static_cast<BufferOperation>(i))
+                << " count=" << h.count()
+                << " p50=" << h.percentile(0.5)
+                << " p99=" << h.percentile(0.99)
+                << " p99.9=" << h.percentile(0.999)
+                << " max=" << h.max() << "ns\n";
+        }
+    }
+
+private:
+    LatencyHistogram histograms_[kBufferOperationCount];
+};
@@ -0,0 +1,326 @@
+#pragma once
+
+#include "CircularBufferBase.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Ring state is written to the two slots alternately, so a torn update leaves the previous slot intact.
+struct MappedRingState {
+    std::uint64_t sequence;
+    std::uint64_t head;
+    std::uint64_t size;
+    std::uint64_t checksum;
+};
+
+struct alignas(64) MappedRingHeader {
+    std::uint64_t magic;
+    std::uint64_t capacity;
+    std::uint64_t element_size;
+    MappedRingState states[2];
+};
+
+// Fixed-capacity overwriting ring kept in a MAP_SHARED file: contents survive a process crash and are recovered
+// on reopen from the header alone. Call flush() to make them durable against power loss.
+//
+// Like CircularBufferBase the file holds capacity + 1 slots, so a push always writes a slot outside the live
+// range and only then publishes the new head and size; a crash in between leaves the previous state intact.
+template<typename T>
+class MappedCircularBuffer {
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "MappedCircularBuffer stores raw bytes of T");
+    static_assert(alignof(T) <= alignof(MappedRingHeader), "Over-aligned T is not supported");
+
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = std::size_t;
+
+    static constexpr std::uint64_t kMagic = 0x4342554646455231; // "CBUFFER1"
+
+    // Opens the ring stored at path, or creates it if the file is missing or empty.
+    MappedCircularBuffer(const std::filesystem::path& path, size_type capacity);
+
+    MappedCircularBuffer(const MappedCircularBuffer&) = delete;
+
+    MappedCircularBuffer& operator=(const MappedCircularBuffer&) = delete;
+
+    ~MappedCircularBuffer();
+
+    void push_back(const T& value);
+
+    value_type pop_front();
+
+    reference operator[](size_type i);
+
+    const_reference operator[](size_type i) const;
+
+    const_reference front() const;
+
+    const_reference back() const;
+
+    RingRegions<const T> peek(size_type n) const;
+
+    void clear();
+
+    size_type size() const noexcept;
+
+    size_type capacity() const noexcept;
+
+    bool empty() const noexcept;
+
+    // Number of committed mutations since the file was created.
+    std::uint64_t sequence() const noexcept;
+
+    // msync(MS_SYNC) of the whole mapping.
+    void flush();
+
+    // msync(MS_ASYNC): schedules write-back without waiting for it.
+    void flush_async();
+
+private:
+    static std::uint64_t checksum(const MappedRingHeader& header, const MappedRingState& state) noexcept;
+
+    static size_type mapping_size(size_type capacity) noexcept;
+
+    size_type slot(size_type i) const noexcept;
+
+    void publish(size_type head, size_type size) noexcept;
+
+    void sync(int flags);
+
+    int fd_ = -1;
+    size_type mapping_size_ = 0;
+    MappedRingHeader* header_ = nullptr;
+    T* data_ = nullptr;
+
+    size_type capacity_ = 0;
+    size_type head_ = 0;
+    size_type size_ = 0;
+    std::uint64_t sequence_ = 0;
+};
+
+
+template<typename T>
+MappedCircularBuffer<T>::MappedCircularBuffer(const std::filesystem::path& path, size_type capacity)
+        : capacity_(capacity) {
+    if (capacity == 0) {
+        throw std::invalid_argument("MappedCircularBuffer capacity must be positive");
+    }
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ < 0) {
+        throw std::system_error(errno, std::generic_category(), "open " + path.string());
+    }
+    mapping_size_ = mapping_size(capacity);
+
+    struct stat st{};
+    if (::fstat(fd_, &st) != 0) {
+        const int error = errno;
+        ::close(fd_);
+        throw std::system_error(error, std::generic_category(), "fstat " + path.string());
+    }
+    const bool fresh = st.st_size == 0;
+    if (fresh && ::ftruncate(fd_, static_cast<off_t>(mapping_size_)) != 0) {
+        const int error = errno;
+        ::close(fd_);
+        throw std::system_error(error, std::generic_category(), "ftruncate " + path.string());
+    }
+    if (!fresh && static_cast<size_type>(st.st_size) != mapping_size_) {
+        ::close(fd_);
+        throw std::invalid_argument("File size doesn't match the requested capacity");
+    }
+
+    void* mapping = ::mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mapping == MAP_FAILED) {
+        const int error = errno;
+        ::close(fd_);
+        throw std::system_error(error, std::generic_category(), "mmap " + path.string());
+    }
+    header_ = static_cast<MappedRingHeader*>(mapping);
+    data_ = reinterpret_cast<T*>(header_ + 1);
+
+    if (fresh) {
+        header_->magic = kMagic;
+        header_->capacity = capacity;
+        header_->element_size = sizeof(T);
+        header_->states[1] = {};
+        header_->states[0] = {0, 0, 0, 0};
+        header_->states[0].checksum = checksum(*header_, header_->states[0]);
+        return;
+    }
+
+    if (header_->magic != kMagic || header_->capacity != capacity || header_->element_size != sizeof(T)) {
+        ::munmap(mapping, mapping_size_);
+        ::close(fd_);
+        throw std::invalid_argument("File doesn't contain a ring of this type and capacity");
+    }
+    const MappedRingState* recovered = nullptr;
+    for (const auto& state : header_->states) {
+        if (state.checksum == checksum(*header_, state) && state.head <= capacity && state.size <= capacity &&
+            (recovered == nullptr || state.sequence > recovered->sequence)) {
+            recovered = &state;
+        }
+    }
+    if (recovered == nullptr) {
+        ::munmap(mapping, mapping_size_);
+        ::close(fd_);
+        throw std::runtime_error("Both ring headers are corrupted");
+    }
+    sequence_ = recovered->sequence;
+    head_ = recovered->head;
+    size_ = recovered->size;
+}
+
+template<typename T>
+MappedCircularBuffer<T>::~MappedCircularBuffer() {
+    ::munmap(header_, mapping_size_);
+    ::close(fd_);
+}
+
+template<typename T>
+std::uint64_t MappedCircularBuffer<T>::checksum(const MappedRingHeader& header, const MappedRingState& state) noexcept {
+    // FNV-1a over the header constants and the state fields, never 0 so a zeroed slot is invalid.
+    std::uint64_t hash = 0xcbf29ce484222325;
+    for (std::uint64_t word : {header.magic, header.capacity, header.element_size,
+                               state.sequence, state.head, state.size}) {
+        for (int i = 0; i < 8; ++i) {
+            hash ^= (word >> (8 * i)) & 0xff;
+            hash *= 0x100000001b3;
+        }
+    }
+    return hash == 0 ? 1 : hash;
+}
+
+template<typename T>
+MappedCircularBuffer<T>::size_type MappedCircularBuffer<T>::mapping_size(size_type capacity) noexcept {
+    return sizeof(MappedRingHeader) + (capacity + 1) * sizeof(T);
+}
+
+template<typename T>
+MappedCircularBuffer<T>::size_type MappedCircularBuffer<T>::slot(size_type i) const noexcept {
+    return (head_ + i) % (capacity_ + 1);
+}
+
+template<typename T>
+void MappedCircularBuffer<T>::publish(size_type head, size_type size) noexcept {
+    // Slot data written before the call must reach the mapping before any state that refers to it.
+    std::atomic_thread_fence(std::memory_order_release);
+    MappedRingState& state = header_->states[(sequence_ + 1) % 2];
+    state.checksum = 0;
+    state.sequence = sequence_ + 1;
+    state.head = head;
+    state.size = size;
+    std::atomic_thread_fence(std::memory_order_release);
+    state.checksum = checksum(*header_, state);
+
+    ++sequence_;
+    head_ = head;
+    size_ = size;
+}
+
+template<typename T>
+void MappedCircularBuffer<T>::push_back(const T& value) {
+    // The spare slot: never live, even when the ring is full.
+    std::memcpy(static_cast<void*>(data_ + slot(size_)), &value, sizeof(T));
+    if (size_ == capacity_) {
+        publish(slot(1), size_);
+    } else {
+        publish(head_, size_ + 1);
+    }
+}
+
+template<typename T>
+MappedCircularBuffer<T>::value_type MappedCircularBuffer<T>::pop_front() {
+    if (empty()) {
+        throw std::out_of_range("Trying to pop_front() from an empty buffer");
+    }
+    value_type to_return = data_[head_];
+    publish(slot(1), size_ - 1);
+    return to_return;
+}
+
+template<typename T>
+MappedCircularBuffer<T>::reference MappedCircularBuffer<T>::operator[](size_type i) {
+    return data_[slot(i)];
+}
+
+template<typename T>
+MappedCircularBuffer<T>::const_reference MappedCircularBuffer<T>::operator[](size_type i) const {
+    return data_[slot(i)];
+}
+
+template<typename T>
+MappedCircularBuffer<T>::const_reference MappedCircularBuffer<T>::front() const {
+    if (empty()) {
+        throw std::out_of_range("Trying to get data from empty buffer");
+    }
+    return data_[head_];
+}
+
+template<typename T>
+MappedCircularBuffer<T>::const_reference MappedCircularBuffer<T>::back() const {
+    if (empty()) {
+        throw std::out_of_range("Trying to get data from empty buffer");
+    }
+    return data_[slot(size_ - 1)];
+}
+
+template<typename T>
+RingRegions<const T> MappedCircularBuffer<T>::peek(size_type n) const {
+    n = std::min(n, size_);
+    const size_type to_end = capacity_ + 1 - head_;
+    if (n <= to_end) {
+        return {std::span<const T>(data_ + head_, n), std::span<const T>()};
+    }
+    return {std::span<const T>(data_ + head_, to_end), std::span<const T>(data_, n - to_end)};
+}
+
+template<typename T>
+void MappedCircularBuffer<T>::clear() {
+    publish(0, 0);
+}
+
+template<typename T>
+MappedCircularBuffer<T>::size_type MappedCircularBuffer<T>::size() const noexcept {
+    return size_;
+}
+
+template<typename T>
+MappedCircularBuffer<T>::size_type MappedCircularBuffer<T>::capacity() const noexcept {
+    return capacity_;
+}
+
+template<typename T>
+bool MappedCircularBuffer<T>::empty() const noexcept {
+    return size_ == 0;
+}
+
+template<typename T>
+std::uint64_t MappedCircularBuffer<T>::sequence() const noexcept {
+    return sequence_;
+}
+
+template<typename T>
+void MappedCircularBuffer<T>::sync(int flags) {
+    if (::msync(header_, mapping_size_, flags) != 0) {
+        throw std::system_error(errno, std::generic_category(), "msync");
+    }
+}
+
+template<typename T>
+void MappedCircularBuffer<T>::flush() {
+    sync(MS_SYNC);
+}
+
+template<typename T>
+void MappedCircularBuffer<T>::flush_async() {
+    sync(MS_ASYNC);
+}
@@ -0,0 +1,212 @@
+#pragma once
+
+#include "BufferChecks.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <span>
+#include <utility>
+
+// Chunked algorithms over the logical contents of a ring (anything with size() and peek(n)). Every chunk is
+// handed out as at most two contiguous spans, so the inner loops never see the wrap point.
+//
+// The policies mirror std::execution::seq/par. They are separate tags because libstdc++'s <execution>
+// pulls in a TBB link dependency wherever TBB headers are installed. Passing a ThreadPool instead of a
+// policy runs on that pool.
+namespace parallel {
+
+struct sequenced_policy {};
+
+struct parallel_policy {};
+
+inline constexpr sequenced_policy seq{};
+inline constexpr parallel_policy par{};
+
+namespace detail {
+
+// Below this many elements per chunk the fork-join overhead outweighs the work.
+inline constexpr std::size_t kMinChunk = std::size_t{1} << 14;
+
+inline std::size_t chunk_count(std::size_t n, const ThreadPool& pool) noexcept {
+    if (pool.size() == 1 || n < 2 * kMinChunk) {
+        return 1;
+    }
+    return std::min(pool.size() * 4, n / kMinChunk);
+}
+
+// Calls f(span, index of span[0]) for the contiguous pieces of the logical range [begin, end).
+template<typename Buffer, typename F>
+void for_segments(Buffer& cb, std::size_t begin, std::size_t end, F&& f) {
+    const auto regions = cb.peek(end);
+    if (begin < regions.first.size()) {
+        f(regions.first.subspan(begin), begin);
+        if (!regions.second.empty()) {
+            f(regions.second, regions.first.size());
+        }
+    } else if (begin < end) {
+        f(regions.second.subspan(begin - regions.first.size()), begin);
+    }
+}
+
+// Splits [0, n) into chunks and runs f(begin, end) for each of them on the pool.
+template<typename F>
+std::size_t run_chunks(ThreadPool& pool, std::size_t n, F&& f) {
+    const std::size_t chunks = chunk_count(n, pool);
+    pool.run(chunks, [&](std::size_t i) { f(n * i / chunks, n * (i + 1) / chunks); });
+    return chunks;
+}
+
+} // namespace detail
+
+template<typename Buffer, typename F>
+void for_each(ThreadPool& pool, Buffer& cb, F f) {
+    detail::run_chunks(pool, cb.size(), [&](std::size_t begin, std::size_t end) {
+        detail::for_segments(cb, begin, end, [&](auto segment, std::size_t) {
+            std::for_each(segment.begin(), segment.end(), f);
+        });
+    });
+}
+
+template<typename Buffer, typename F>
+void for_each(sequenced_policy, Buffer& cb, F f) {
+    detail::for_segments(cb, 0, cb.size(), [&](auto segment, std::size_t) {
+        std::for_each(segment.begin(), segment.end(), f);
+    });
+}
+
+template<typename Buffer, typename F>
+void for_each(parallel_policy, Buffer& cb, F f) {
+    for_each(ThreadPool::shared(), cb, std::move(f));
+}
+
+// dst[i] = op(src[i]) for every logical index of src; dst must already hold at least src.size() elements.
+template<typename Src, typename Dst, typename UnaryOp>
+void transform(ThreadPool& pool, const Src& src, Dst& dst, UnaryOp op) {
+    CIRCULAR_BUFFER_CHECK(dst.size() >= src.size(), "Destination is smaller than the source");
+    detail::run_chunks(pool, src.size(), [&](std::size_t begin, std::size_t end) {
+        detail::for_segments(src, begin, end, [&](auto in, std::size_t in_index) {
+            detail::for_segments(dst, in_index, in_index + in.size(), [&](auto out, std::size_t out_index) {
+                const auto first = in.begin() + (out_index - in_index);
+                std::transform(first, first + out.size(), out.begin(), op);
+            });
+        });
+    });
+}
+
+template<typename Src, typename Dst, typename UnaryOp>
+void transform(sequenced_policy, const Src& src, Dst& dst, UnaryOp op) {
+    ThreadPool inline_pool(1);
+    transform(inline_pool, src, dst, std::move(op));
+}
+
+template<typename Src, typename Dst, typename UnaryOp>
+void transform(parallel_policy, const Src& src, Dst& dst, UnaryOp op) {
+    transform(ThreadPool::shared(), src, dst, std::move(op));
+}
+
+// Folds every element into init with op, which must be associative: chunks are reduced independently.
+template<typename Buffer, typename T, typename BinaryOp = std::plus<>>
+T reduce(ThreadPool& pool, const Buffer& cb, T init, BinaryOp op = {}) {
+    const std::size_t chunks = detail::chunk_count(cb.size(), pool);
+    auto partials = std::make_unique<std::optional<T>[]>(chunks);
+    const std::size_t n = cb.size();
+    pool.run(chunks, [&](std::size_t i) {
+        std::optional<T>& partial = partials[i];
+        detail::for_segments(cb, n * i / chunks, n * (i + 1) / chunks, [&](auto segment, std::size_t) {
+            for (const auto& value: segment) {
+                partial = (partial ? op(std::move(*partial), value) : T(value));
+            }
+        });
+    });
+    for (std::size_t i = 0; i < chunks; ++i) {
+        if (partials[i]) {
+            init = op(std::move(init), std::move(*partials[i]));
+        }
+    }
+    return init;
+}
+
+template<typename Buffer, typename T, typename BinaryOp = std::plus<>>
+T reduce(sequenced_policy, const Buffer& cb, T init, BinaryOp op = {}) {
+    detail::for_segments(cb, 0, cb.size(), [&](auto segment, std::size_t) {
+        for (const auto& value: segment) {
+            init = op(std::move(init), value);
+        }
+    });
+    return init;
+}
+
+template<typename Buffer, typename T, typename BinaryOp = std::plus<>>
+T reduce(parallel_policy, const Buffer& cb, T init, BinaryOp op = {}) {
+    return reduce(ThreadPool::shared(), cb, std::move(init), std::move(op));
+}
+
+// Sorts chunks in parallel into a scratch array, merges them pairwise in rounds and moves the result back.
+// Needs 2 * size() default-constructible scratch elements.
+template<typename Buffer, typename Compare = std::less<>>
+void sort(ThreadPool& pool, Buffer& cb, Compare comp = {}) {
+    using T = typename Buffer::value_type;
+    const std::size_t n = cb.size();
+    const std::size_t chunks = detail::chunk_count(n, pool);
+    if (chunks == 1) {
+        const auto regions = cb.peek(n);
+        if (regions.second.empty()) {
+            std::sort(regions.first.begin(), regions.first.end(), comp);
+        } else {
+            std::sort(cb.begin(), cb.end(), comp);
+        }
+        return;
+    }
+
+    auto from = std::make_unique<T[]>(n);
+    auto to = std::make_unique<T[]>(n);
+    auto bounds = std::make_unique<std::size_t[]>(chunks + 1);
+    for (std::size_t i = 0; i <= chunks; ++i) {
+        bounds[i] = n * i / chunks;
+    }
+    pool.run(chunks, [&](std::size_t i) {
+        detail::for_segments(cb, bounds[i], bounds[i + 1], [&](auto segment, std::size_t index) {
+            std::move(segment.begin(), segment.end(), from.get() + index);
+        });
+        std::sort(from.get() + bounds[i], from.get() + bounds[i + 1], comp);
+    });
+
+    for (std::size_t runs = chunks; runs > 1; runs = (runs + 1) / 2) {
+        pool.run((runs + 1) / 2, [&](std::size_t pair) {
+            const std::size_t first = bounds[2 * pair];
+            const std::size_t middle = bounds[std::min(2 * pair + 1, runs)];
+            const std::size_t last = bounds[std::min(2 * pair + 2, runs)];
+            std::merge(std::make_move_iterator(from.get() + first), std::make_move_iterator(from.get() + middle),
+                       std::make_move_iterator(from.get() + middle), std::make_move_iterator(from.get() + last),
+                       to.get() + first, comp);
+        });
+        for (std::size_t i = 0; i <= (runs + 1) / 2; ++i) {
+            bounds[i] = bounds[std::min(2 * i, runs)];
+        }
+        std::swap(from, to);
+    }
+
+    detail::run_chunks(pool, n, [&](std::size_t begin, std::size_t end) {
+        detail::for_segments(cb, begin, end, [&](auto segment, std::size_t index) {
+            std::move(from.get() + index, from.get() + index + segment.size(), segment.begin());
+        });
+    });
+}
+
+template<typename Buffer, typename Compare = std::less<>>
+void sort(sequenced_policy, Buffer& cb, Compare comp = {}) {
+    ThreadPool inline_pool(1);
+    sort(inline_pool, cb, std::move(comp));
+}
+
+template<typename Buffer, typename Compare = std::less<>>
+void sort(parallel_policy, Buffer& cb, Compare comp = {}) {
+    sort(ThreadPool::shared(), cb, std::move(comp));
+}
+
+} // namespace parallel
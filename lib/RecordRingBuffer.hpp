@@ -0,0 +1,260 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <stdexcept>
+
+// Bip-buffer of length-prefixed byte records. Records are contiguous and never split across the wrap point:
+// data lives in region A and, once the tail runs out of room, in region B growing from the buffer start.
+template<typename Alloc = std::allocator<std::byte>>
+class RecordRingBuffer {
+public:
+    // Words keep every record header and payload 8-byte aligned.
+    using allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<std::uint64_t>;
+    using AllocTraits = typename std::allocator_traits<Alloc>::template rebind_traits<std::uint64_t>;
+
+    using size_type = std::size_t;
+
+    static constexpr size_type kHeaderSize = sizeof(std::uint64_t);
+
+    explicit RecordRingBuffer(size_type capacity_bytes, const Alloc& allocator = Alloc());
+
+    RecordRingBuffer(const RecordRingBuffer&) = delete;
+
+    RecordRingBuffer(RecordRingBuffer&& other) noexcept;
+
+    RecordRingBuffer& operator=(const RecordRingBuffer&) = delete;
+
+    ~RecordRingBuffer();
+
+    // Writable payload for a record of len bytes; empty span if it doesn't fit right now.
+    std::span<std::byte> reserve(size_type len);
+
+    // Publishes the reserved record, possibly shortened to len bytes.
+    void commit(size_type len);
+
+    std::span<std::byte> front_record();
+
+    std::span<const std::byte> front_record() const;
+
+    void pop_record();
+
+    // Calls f(std::span<const std::byte>) for every committed record, oldest first.
+    template<typename F>
+    void for_each_record(F&& f) const;
+
+    void clear() noexcept;
+
+    // Bytes taken by a record of len bytes, header and padding included.
+    static constexpr size_type record_footprint(size_type len) noexcept;
+
+    size_type records() const noexcept;
+
+    size_type bytes_used() const noexcept;
+
+    size_type capacity() const noexcept;
+
+    bool empty() const noexcept;
+
+    allocator_type get_allocator() const noexcept;
+
+private:
+    static constexpr size_type kNoReservation = static_cast<size_type>(-1);
+
+    std::byte* bytes() const noexcept;
+
+    void promote_b_if_a_empty() noexcept;
+
+    [[no_unique_address]] allocator_type allocator_;
+    std::uint64_t* words_;
+    size_type capacity_;
+
+    size_type a_start_ = 0;
+    size_type a_end_ = 0;
+    size_type b_end_ = 0;
+    bool has_b_ = false;
+    size_type records_ = 0;
+
+    size_type reserved_at_ = kNoReservation;
+    size_type reserved_len_ = 0;
+};
+
+
+template<typename Alloc>
+RecordRingBuffer<Alloc>::RecordRingBuffer(size_type capacity_bytes, const Alloc& allocator)
+        : allocator_(allocator),
+          words_(AllocTraits::allocate(allocator_, (capacity_bytes + kHeaderSize - 1) / kHeaderSize)),
+          capacity_((capacity_bytes + kHeaderSize - 1) / kHeaderSize * kHeaderSize) {}
+
+template<typename Alloc>
+RecordRingBuffer<Alloc>::RecordRingBuffer(RecordRingBuffer&& other) noexcept
+        : allocator_(std::move(other.allocator_)),
+          words_(other.words_),
+          capacity_(other.capacity_),
+          a_start_(other.a_start_),
+          a_end_(other.a_end_),
+          b_end_(other.b_end_),
+          has_b_(other.has_b_),
+          records_(other.records_),
+          reserved_at_(other.reserved_at_),
+          reserved_len_(other.reserved_len_) {
+    other.words_ = nullptr;
+    other.capacity_ = 0;
+    other.clear();
+}
+
+template<typename Alloc>
+RecordRingBuffer<Alloc>::~RecordRingBuffer() {
+    if (words_ != nullptr) {
+        AllocTraits::deallocate(allocator_, words_, capacity_ / kHeaderSize);
+    }
+}
+
+template<typename Alloc>
+constexpr RecordRingBuffer<Alloc>::size_type RecordRingBuffer<Alloc>::record_footprint(size_type len) noexcept {
+    return kHeaderSize + (len + kHeaderSize - 1) / kHeaderSize * kHeaderSize;
+}
+
+template<typename Alloc>
+std::byte* RecordRingBuffer<Alloc>::bytes() const noexcept {
+    return reinterpret_cast<std::byte*>(words_);
+}
+
+template<typename Alloc>
+std::span<std::byte> RecordRingBuffer<Alloc>::reserve(size_type len) {
+    const size_type need = record_footprint(len);
+    reserved_at_ = kNoReservation;
+    if (has_b_) {
+        if (a_start_ - b_end_ >= need) {
+            reserved_at_ = b_end_;
+        }
+    } else if (capacity_ - a_end_ >= need) {
+        reserved_at_ = a_end_;
+    } else if (a_start_ >= need) {
+        reserved_at_ = 0;
+    }
+    if (reserved_at_ == kNoReservation) {
+        return {};
+    }
+    reserved_len_ = len;
+    return {bytes() + reserved_at_ + kHeaderSize, len};
+}
+
+template<typename Alloc>
+void RecordRingBuffer<Alloc>::commit(size_type len) {
+    if (reserved_at_ == kNoReservation) {
+        throw std::logic_error("Trying to commit() without a successful reserve()");
+    }
+    if (len > reserved_len_) {
+        throw std::out_of_range("Trying to commit more bytes than were reserved");
+    }
+    const std::uint64_t header = len;
+    std::memcpy(bytes() + reserved_at_, &header, kHeaderSize);
+
+    const size_type record_end = reserved_at_ + record_footprint(len);
+    if (reserved_at_ == a_end_ && !has_b_) {
+        a_end_ = record_end;
+    } else {
+        b_end_ = record_end;
+        has_b_ = true;
+    }
+    ++records_;
+    reserved_at_ = kNoReservation;
+    promote_b_if_a_empty();
+}
+
+template<typename Alloc>
+std::span<std::byte> RecordRingBuffer<Alloc>::front_record() {
+    if (empty()) {
+        throw std::out_of_range("Trying to get a record from an empty buffer");
+    }
+    std::uint64_t len;
+    std::memcpy(&len, bytes() + a_start_, kHeaderSize);
+    return {bytes() + a_start_ + kHeaderSize, static_cast<size_type>(len)};
+}
+
+template<typename Alloc>
+std::span<const std::byte> RecordRingBuffer<Alloc>::front_record() const {
+    if (empty()) {
+        throw std::out_of_range("Trying to get a record from an empty buffer");
+    }
+    std::uint64_t len;
+    std::memcpy(&len, bytes() + a_start_, kHeaderSize);
+    return {bytes() + a_start_ + kHeaderSize, static_cast<size_type>(len)};
+}
+
+template<typename Alloc>
+void RecordRingBuffer<Alloc>::pop_record() {
+    const size_type len = front_record().size();
+    a_start_ += record_footprint(len);
+    --records_;
+    promote_b_if_a_empty();
+}
+
+template<typename Alloc>
+template<typename F>
+void RecordRingBuffer<Alloc>::for_each_record(F&& f) const {
+    const auto walk = [&](size_type from, size_type to) {
+        while (from < to) {
+            std::uint64_t len;
+            std::memcpy(&len, bytes() + from, kHeaderSize);
+            f(std::span<const std::byte>(bytes() + from + kHeaderSize, static_cast<size_type>(len)));
+            from += record_footprint(static_cast<size_type>(len));
+        }
+    };
+    walk(a_start_, a_end_);
+    if (has_b_) {
+        walk(0, b_end_);
+    }
+}
+
+template<typename Alloc>
+void RecordRingBuffer<Alloc>::promote_b_if_a_empty() noexcept {
+    if (a_start_ != a_end_) {
+        return;
+    }
+    if (has_b_) {
+        a_start_ = 0;
+        a_end_ = b_end_;
+        b_end_ = 0;
+        has_b_ = false;
+    } else if (reserved_at_ == kNoReservation) {
+        a_start_ = a_end_ = 0;
+    }
+}
+
+template<typename Alloc>
+void RecordRingBuffer<Alloc>::clear() noexcept {
+    a_start_ = a_end_ = b_end_ = 0;
+    has_b_ = false;
+    records_ = 0;
+    reserved_at_ = kNoReservation;
+}
+
+template<typename Alloc>
+RecordRingBuffer<Alloc>::size_type RecordRingBuffer<Alloc>::records() const noexcept {
+    return records_;
+}
+
+template<typename Alloc>
+RecordRingBuffer<Alloc>::size_type RecordRingBuffer<Alloc>::bytes_used() const noexcept {
+    return (a_end_ - a_start_) + (has_b_ ? b_end_ : 0);
+}
+
+template<typename Alloc>
+RecordRingBuffer<Alloc>::size_type RecordRingBuffer<Alloc>::capacity() const noexcept {
+    return capacity_;
+}
+
+template<typename Alloc>
+bool RecordRingBuffer<Alloc>::empty() const noexcept {
+    return records_ == 0;
+}
+
+template<typename Alloc>
+RecordRingBuffer<Alloc>::allocator_type RecordRingBuffer<Alloc>::get_allocator() const noexcept {
+    return allocator_;
+}
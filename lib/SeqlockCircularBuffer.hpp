@@ -0,0 +1,210 @@
+#pragma once
+
+#include "CircularBuffer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+// Overwriting ring with one writer and any number of concurrent readers. The writer makes the sequence counter
+// odd around every mutation and never waits; readers copy the newest entries optimistically and retry when the
+// counter moved under them, so neither side takes a lock.
+template<typename T, typename Alloc = std::allocator<T>>
+class SeqlockCircularBuffer {
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "Readers copy slots that may be torn by the writer");
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using allocator_type = Alloc;
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+    SeqlockCircularBuffer() noexcept : SeqlockCircularBuffer(0) {}
+
+    explicit SeqlockCircularBuffer(size_type capacity, const Alloc& allocator = Alloc());
+
+    // Moving is not synchronised with readers or the writer.
+    SeqlockCircularBuffer(SeqlockCircularBuffer&& other) noexcept;
+
+    SeqlockCircularBuffer& operator=(SeqlockCircularBuffer&& other) noexcept;
+
+    ~SeqlockCircularBuffer();
+
+    // Writer side; only one thread at a time.
+    void push_back(const T& value) noexcept;
+
+    // Appends the whole batch inside one write section.
+    void push_back(std::span<const T> values) noexcept;
+
+    void clear() noexcept;
+
+    // Reader side; any thread. Copies the newest min(limit, size()) entries into out, oldest first.
+    size_type snapshot(T* out, size_type limit) const noexcept;
+
+    CircularBuffer<T> last(size_type n) const;
+
+    size_type size() const noexcept;
+
+    size_type capacity() const noexcept;
+
+    // Number of pushes since construction or the last clear().
+    std::uint64_t pushed() const noexcept;
+
+private:
+    void release() noexcept;
+
+    void write(const T* values, size_type count) noexcept;
+
+    [[no_unique_address]] Alloc allocator_;
+    T* slots_;
+    size_type capacity_;
+    // Both are written by the writer only; head_ is read under the seqlock.
+    alignas(64) std::atomic<std::uint64_t> version_{0};
+    std::atomic<std::uint64_t> head_{0};
+};
+
+
+template<typename T, typename Alloc>
+SeqlockCircularBuffer<T, Alloc>::SeqlockCircularBuffer(size_type capacity, const Alloc& allocator)
+        : allocator_(allocator),
+          slots_(capacity == 0 ? nullptr : AllocTraits::allocate(allocator_, capacity)),
+          capacity_(capacity) {}
+
+template<typename T, typename Alloc>
+SeqlockCircularBuffer<T, Alloc>::SeqlockCircularBuffer(SeqlockCircularBuffer&& other) noexcept
+        : allocator_(std::move(other.allocator_)),
+          slots_(std::exchange(other.slots_, nullptr)),
+          capacity_(std::exchange(other.capacity_, 0)),
+          version_(other.version_.load(std::memory_order_relaxed)),
+          head_(other.head_.exchange(0, std::memory_order_relaxed)) {}
+
+template<typename T, typename Alloc>
+SeqlockCircularBuffer<T, Alloc>& SeqlockCircularBuffer<T, Alloc>::operator=(SeqlockCircularBuffer&& other) noexcept {
+    if (this != &other) {
+        release();
+        allocator_ = std::move(other.allocator_);
+        slots_ = std::exchange(other.slots_, nullptr);
+        capacity_ = std::exchange(other.capacity_, 0);
+        version_.store(other.version_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        head_.store(other.head_.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    return *this;
+}
+
+template<typename T, typename Alloc>
+SeqlockCircularBuffer<T, Alloc>::~SeqlockCircularBuffer() {
+    release();
+}
+
+template<typename T, typename Alloc>
+void SeqlockCircularBuffer<T, Alloc>::release() noexcept {
+    if (slots_ != nullptr) {
+        AllocTraits::deallocate(allocator_, slots_, capacity_);
+        slots_ = nullptr;
+    }
+}
+
+template<typename T, typename Alloc>
+void SeqlockCircularBuffer<T, Alloc>::write(const T* values, size_type count) noexcept {
+    if (capacity_ == 0) {
+        return;
+    }
+    const std::uint64_t version = version_.load(std::memory_order_relaxed);
+    version_.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::uint64_t head = head_.load(std::memory_order_relaxed);
+    // Only the last capacity() values of the batch survive.
+    if (count > capacity_) {
+        head += count - capacity_;
+        values += count - capacity_;
+        count = capacity_;
+    }
+    const auto at = static_cast<size_type>(head % capacity_);
+    const size_type first = std::min(count, capacity_ - at);
+    std::memcpy(static_cast<void*>(slots_ + at), values, first * sizeof(T));
+    if (first != count) {
+        std::memcpy(static_cast<void*>(slots_), values + first, (count - first) * sizeof(T));
+    }
+    head_.store(head + count, std::memory_order_relaxed);
+
+    version_.store(version + 2, std::memory_order_release);
+}
+
+template<typename T, typename Alloc>
+void SeqlockCircularBuffer<T, Alloc>::push_back(const T& value) noexcept {
+    write(&value, 1);
+}
+
+template<typename T, typename Alloc>
+void SeqlockCircularBuffer<T, Alloc>::push_back(std::span<const T> values) noexcept {
+    if (!values.empty()) {
+        write(values.data(), values.size());
+    }
+}
+
+template<typename T, typename Alloc>
+void SeqlockCircularBuffer<T, Alloc>::clear() noexcept {
+    const std::uint64_t version = version_.load(std::memory_order_relaxed);
+    version_.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    head_.store(0, std::memory_order_relaxed);
+    version_.store(version + 2, std::memory_order_release);
+}
+
+template<typename T, typename Alloc>
+SeqlockCircularBuffer<T, Alloc>::size_type
+SeqlockCircularBuffer<T, Alloc>::snapshot(T* out, size_type limit) const noexcept {
+    for (;;) {
+        const std::uint64_t version = version_.load(std::memory_order_acquire);
+        if (version % 2 != 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        const std::uint64_t head = head_.load(std::memory_order_relaxed);
+        const auto n = static_cast<size_type>(std::min<std::uint64_t>({limit, head, capacity_}));
+        if (n != 0) {
+            const auto at = static_cast<size_type>((head - n) % capacity_);
+            const size_type first = std::min(n, capacity_ - at);
+            std::memcpy(static_cast<void*>(out), slots_ + at, first * sizeof(T));
+            if (first != n) {
+                std::memcpy(static_cast<void*>(out + first), slots_, (n - first) * sizeof(T));
+            }
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (version_.load(std::memory_order_relaxed) == version) {
+            return n;
+        }
+    }
+}
+
+template<typename T, typename Alloc>
+CircularBuffer<T> SeqlockCircularBuffer<T, Alloc>::last(size_type n) const {
+    CircularBuffer<T> result(n);
+    // A fresh buffer's free slots are one contiguous run.
+    const auto free = result.prepare(n);
+    result.commit(snapshot(free.first.data(), free.first.size()));
+    return result;
+}
+
+template<typename T, typename Alloc>
+SeqlockCircularBuffer<T, Alloc>::size_type SeqlockCircularBuffer<T, Alloc>::size() const noexcept {
+    return static_cast<size_type>(std::min<std::uint64_t>(head_.load(std::memory_order_acquire), capacity_));
+}
+
+template<typename T, typename Alloc>
+SeqlockCircularBuffer<T, Alloc>::size_type SeqlockCircularBuffer<T, Alloc>::capacity() const noexcept {
+    return capacity_;
+}
+
+template<typename T, typename Alloc>
+std::uint64_t SeqlockCircularBuffer<T, Alloc>::pushed() const noexcept {
+    return head_.load(std::memory_order_acquire);
+}
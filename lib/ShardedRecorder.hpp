@@ -0,0 +1,208 @@
+#pragma once
+
+#include "CircularBuffer.hpp"
+#include "CircularBufferExt.hpp"
+#include "SeqlockCircularBuffer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+template<typename T>
+struct Stamped {
+    std::uint64_t timestamp;
+    // Position within the recording shard; breaks timestamp ties together with the shard index.
+    std::uint64_t sequence;
+    std::uint32_t shard;
+    T value;
+};
+
+// Event recorder for many writer threads. Every writer() handle owns a shard - a SeqlockCircularBuffer - so
+// recording never takes a lock or touches a shared cache line. Readers copy the
+// shards out and merge them by (timestamp, shard, sequence) on demand.
+template<typename T, typename Clock = std::chrono::steady_clock>
+class ShardedRecorder {
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "Shards are copied out under a seqlock");
+
+    using size_type = std::size_t;
+    using entry_type = Stamped<T>;
+
+    class Writer;
+
+    // shard_capacity events are kept per writer; at most max_writers handles may be created.
+    ShardedRecorder(size_type shard_capacity, size_type max_writers);
+
+    ShardedRecorder(const ShardedRecorder&) = delete;
+
+    ShardedRecorder& operator=(const ShardedRecorder&) = delete;
+
+    // Registers a new shard. The handle must be used by one thread at a time; the shard outlives the handle.
+    Writer writer();
+
+    // Every retained event of every shard in global order.
+    CircularBufferExt<entry_type> collect() const;
+
+    // The n most recent retained events across all shards, oldest first.
+    CircularBuffer<entry_type> last(size_type n) const;
+
+    size_type shard_capacity() const noexcept;
+
+    size_type writers() const noexcept;
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<bool> ready{false};
+        std::uint64_t next_sequence = 0;
+        SeqlockCircularBuffer<entry_type> ring;
+    };
+
+    // Copies up to the newest `limit` events of a ready shard into out; returns how many were copied.
+    static size_type snapshot(const Shard& shard, entry_type* out, size_type limit) noexcept;
+
+    // Merges the sorted runs [runs[i], runs[i] + lengths[i]) and hands every entry to sink in order.
+    template<typename Sink>
+    static void merge(entry_type* const* runs, const size_type* lengths, size_type count, Sink&& sink);
+
+    static bool before(const entry_type& lhs, const entry_type& rhs) noexcept;
+
+    size_type shard_capacity_;
+    size_type max_writers_;
+    std::unique_ptr<Shard[]> shards_;
+    std::atomic<size_type> claimed_{0};
+};
+
+template<typename T, typename Clock>
+class ShardedRecorder<T, Clock>::Writer {
+public:
+    void record(const T& value) noexcept;
+
+private:
+    friend class ShardedRecorder;
+
+    Writer(Shard* shard, std::uint32_t index) noexcept : shard_(shard), index_(index) {}
+
+    Shard* shard_;
+    std::uint32_t index_;
+};
+
+template<typename T, typename Clock>
+ShardedRecorder<T, Clock>::ShardedRecorder(size_type shard_capacity, size_type max_writers)
+        : shard_capacity_(shard_capacity),
+          max_writers_(max_writers),
+          shards_(std::make_unique<Shard[]>(max_writers)) {}
+
+template<typename T, typename Clock>
+ShardedRecorder<T, Clock>::Writer ShardedRecorder<T, Clock>::writer() {
+    const size_type index = claimed_.fetch_add(1, std::memory_order_relaxed);
+    if (index >= max_writers_) {
+        claimed_.fetch_sub(1, std::memory_order_relaxed);
+        throw std::length_error("ShardedRecorder has no free shards");
+    }
+    Shard& shard = shards_[index];
+    shard.ring = SeqlockCircularBuffer<entry_type>(shard_capacity_);
+    shard.ready.store(true, std::memory_order_release);
+    return Writer(&shard, static_cast<std::uint32_t>(index));
+}
+
+template<typename T, typename Clock>
+void ShardedRecorder<T, Clock>::Writer::record(const T& value) noexcept {
+    const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch());
+    shard_->ring.push_back(entry_type{static_cast<std::uint64_t>(now.count()), shard_->next_sequence++, index_, value});
+}
+
+template<typename T, typename Clock>
+ShardedRecorder<T, Clock>::size_type
+ShardedRecorder<T, Clock>::snapshot(const Shard& shard, entry_type* out, size_type limit) noexcept {
+    return shard.ready.load(std::memory_order_acquire) ? shard.ring.snapshot(out, limit) : 0;
+}
+
+template<typename T, typename Clock>
+bool ShardedRecorder<T, Clock>::before(const entry_type& lhs, const entry_type& rhs) noexcept {
+    if (lhs.timestamp != rhs.timestamp) {
+        return lhs.timestamp < rhs.timestamp;
+    }
+    if (lhs.shard != rhs.shard) {
+        return lhs.shard < rhs.shard;
+    }
+    return lhs.sequence < rhs.sequence;
+}
+
+template<typename T, typename Clock>
+template<typename Sink>
+void ShardedRecorder<T, Clock>::merge(entry_type* const* runs, const size_type* lengths, size_type count, Sink&& sink) {
+    struct Cursor {
+        const entry_type* current;
+        const entry_type* end;
+    };
+    auto heap = std::make_unique<Cursor[]>(count);
+    size_type heap_size = 0;
+    for (size_type i = 0; i < count; ++i) {
+        if (lengths[i] != 0) {
+            heap[heap_size++] = Cursor{runs[i], runs[i] + lengths[i]};
+        }
+    }
+    const auto later = [](const Cursor& lhs, const Cursor& rhs) { return before(*rhs.current, *lhs.current); };
+    std::make_heap(heap.get(), heap.get() + heap_size, later);
+    while (heap_size != 0) {
+        std::pop_heap(heap.get(), heap.get() + heap_size, later);
+        Cursor& cursor = heap[heap_size - 1];
+        sink(*cursor.current);
+        if (++cursor.current == cursor.end) {
+            --heap_size;
+        } else {
+            std::push_heap(heap.get(), heap.get() + heap_size, later);
+        }
+    }
+}
+
+template<typename T, typename Clock>
+CircularBufferExt<typename ShardedRecorder<T, Clock>::entry_type> ShardedRecorder<T, Clock>::collect() const {
+    const size_type count = writers();
+    auto storage = std::make_unique_for_overwrite<entry_type[]>(count * shard_capacity_);
+    auto runs = std::make_unique<entry_type*[]>(count);
+    auto lengths = std::make_unique<size_type[]>(count);
+    size_type total = 0;
+    for (size_type i = 0; i < count; ++i) {
+        runs[i] = storage.get() + i * shard_capacity_;
+        lengths[i] = snapshot(shards_[i], runs[i], shard_capacity_);
+        total += lengths[i];
+    }
+
+    CircularBufferExt<entry_type> result;
+    result.reserve(total);
+    merge(runs.get(), lengths.get(), count, [&result](const entry_type& entry) { result.push_back(entry); });
+    return result;
+}
+
+template<typename T, typename Clock>
+CircularBuffer<typename ShardedRecorder<T, Clock>::entry_type> ShardedRecorder<T, Clock>::last(size_type n) const {
+    // The newest n events overall are among the newest n of each shard.
+    const size_type count = writers();
+    const size_type per_shard = std::min(n, shard_capacity_);
+    auto storage = std::make_unique_for_overwrite<entry_type[]>(count * per_shard);
+    auto runs = std::make_unique<entry_type*[]>(count);
+    auto lengths = std::make_unique<size_type[]>(count);
+    for (size_type i = 0; i < count; ++i) {
+        runs[i] = storage.get() + i * per_shard;
+        lengths[i] = snapshot(shards_[i], runs[i], per_shard);
+    }
+
+    CircularBuffer<entry_type> result(n);
+    merge(runs.get(), lengths.get(), count, [&result](const entry_type& entry) { result.push_back(entry); });
+    return result;
+}
+
+template<typename T, typename Clock>
+ShardedRecorder<T, Clock>::size_type ShardedRecorder<T, Clock>::shard_capacity() const noexcept {
+    return shard_capacity_;
+}
+
+template<typename T, typename Clock>
+ShardedRecorder<T, Clock>::size_type ShardedRecorder<T, Clock>::writers() const noexcept {
+    return std::min(claimed_.load(std::memory_order_acquire), max_writers_);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+// Binary search over rings whose contents are sorted by proj under comp, e.g. records ordered by timestamp.
+// The search runs on the two contiguous segments from peek() instead of stepping CommonIterator, and only the
+// result is turned into an iterator.
+namespace sorted {
+
+namespace detail {
+
+// Logical index of the first element e for which goes_right(e) is false, given the buffer is partitioned.
+template<typename Buffer, typename GoesRight>
+std::size_t partition_point(const Buffer& cb, GoesRight goes_right) {
+    const auto regions = cb.peek(cb.size());
+    if (!regions.second.empty() && goes_right(regions.first.back())) {
+        return regions.first.size() +
+               (std::partition_point(regions.second.begin(), regions.second.end(), goes_right) - regions.second.begin());
+    }
+    return std::partition_point(regions.first.begin(), regions.first.end(), goes_right) - regions.first.begin();
+}
+
+} // namespace detail
+
+// Index of the first element whose key is not less than key.
+template<typename Buffer, typename Key, typename Proj = std::identity, typename Compare = std::ranges::less>
+std::size_t lower_bound_index(const Buffer& cb, const Key& key, Proj proj = {}, Compare comp = {}) {
+    return detail::partition_point(cb, [&](const auto& value) { return std::invoke(comp, std::invoke(proj, value), key); });
+}
+
+// Index of the first element whose key is greater than key.
+template<typename Buffer, typename Key, typename Proj = std::identity, typename Compare = std::ranges::less>
+std::size_t upper_bound_index(const Buffer& cb, const Key& key, Proj proj = {}, Compare comp = {}) {
+    return detail::partition_point(cb, [&](const auto& value) { return !std::invoke(comp, key, std::invoke(proj, value)); });
+}
+
+template<typename Buffer, typename Key, typename Proj = std::identity, typename Compare = std::ranges::less>
+auto lower_bound(Buffer& cb, const Key& key, Proj proj = {}, Compare comp = {}) {
+    return cb.begin() + lower_bound_index(std::as_const(cb), key, std::move(proj), std::move(comp));
+}
+
+template<typename Buffer, typename Key, typename Proj = std::identity, typename Compare = std::ranges::less>
+auto upper_bound(Buffer& cb, const Key& key, Proj proj = {}, Compare comp = {}) {
+    return cb.begin() + upper_bound_index(std::as_const(cb), key, std::move(proj), std::move(comp));
+}
+
+template<typename Buffer, typename Key, typename Proj = std::identity, typename Compare = std::ranges::less>
+auto equal_range(Buffer& cb, const Key& key, Proj proj = {}, Compare comp = {}) {
+    const std::size_t first = lower_bound_index(std::as_const(cb), key, proj, comp);
+    const std::size_t last = upper_bound_index(std::as_const(cb), key, proj, comp);
+    return std::pair(cb.begin() + first, cb.begin() + last);
+}
+
+// Drops every element whose key is less than key from the front; O(log n + k). Returns the removed count.
+template<typename Buffer, typename Key, typename Proj = std::identity, typename Compare = std::ranges::less>
+std::size_t erase_before(Buffer& cb, const Key& key, Proj proj = {}, Compare comp = {}) {
+    const std::size_t n = lower_bound_index(std::as_const(cb), key, std::move(proj), std::move(comp));
+    cb.consume(n);
+    return n;
+}
+
+// Drops every element whose key is greater than key from the back; O(log n + k). Returns the removed count.
+template<typename Buffer, typename Key, typename Proj = std::identity, typename Compare = std::ranges::less>
+std::size_t erase_after(Buffer& cb, const Key& key, Proj proj = {}, Compare comp = {}) {
+    const std::size_t keep = upper_bound_index(std::as_const(cb), key, std::move(proj), std::move(comp));
+    const std::size_t n = cb.size() - keep;
+    if (n != 0) {
+        cb.erase(cb.cbegin() + keep, cb.cend());
+    }
+    return n;
+}
+
+} // namespace sorted
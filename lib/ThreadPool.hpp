@@ -0,0 +1,156 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+// Fork-join pool: run(count, task) executes task(0) ... task(count - 1) on the workers and the calling thread
+// and returns once all of them are done. One job runs at a time; calling run() from inside a task deadlocks.
+class ThreadPool {
+public:
+    // threads counts the caller, so ThreadPool(1) starts no workers and runs everything inline.
+    explicit ThreadPool(std::size_t threads = std::max(1u, std::thread::hardware_concurrency()));
+
+    ThreadPool(const ThreadPool&) = delete;
+
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool();
+
+    std::size_t size() const noexcept {
+        return workers_ + 1;
+    }
+
+    // Rethrows the first exception thrown by a task after every index has been handed out.
+    template<typename F>
+    void run(std::size_t count, F&& task);
+
+    // Process-wide pool with one thread per hardware thread.
+    static ThreadPool& shared();
+
+private:
+    using Invoker = void (*)(void*, std::size_t);
+
+    void worker_loop();
+
+    void drain() noexcept;
+
+    std::unique_ptr<std::thread[]> threads_;
+    std::size_t workers_;
+
+    std::mutex run_mutex_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    std::uint64_t generation_ = 0;
+    std::size_t active_ = 0;
+    bool stop_ = false;
+
+    Invoker invoke_ = nullptr;
+    void* task_ = nullptr;
+    std::size_t count_ = 0;
+    std::atomic<std::size_t> next_{0};
+    std::exception_ptr error_;
+};
+
+inline ThreadPool::ThreadPool(std::size_t threads)
+        : threads_(std::make_unique<std::thread[]>(threads > 1 ? threads - 1 : 0)),
+          workers_(threads > 1 ? threads - 1 : 0) {
+    for (std::size_t i = 0; i < workers_; ++i) {
+        threads_[i] = std::thread([this] { worker_loop(); });
+    }
+}
+
+inline ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (std::size_t i = 0; i < workers_; ++i) {
+        threads_[i].join();
+    }
+}
+
+template<typename F>
+void ThreadPool::run(std::size_t count, F&& task) {
+    if (count == 0) {
+        return;
+    }
+    if (workers_ == 0 || count == 1) {
+        for (std::size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    std::lock_guard run_lock(run_mutex_);
+    {
+        std::lock_guard lock(mutex_);
+        invoke_ = [](void* f, std::size_t i) { (*static_cast<std::remove_reference_t<F>*>(f))(i); };
+        task_ = const_cast<void*>(static_cast<const void*>(std::addressof(task)));
+        count_ = count;
+        next_.store(0, std::memory_order_relaxed);
+        error_ = nullptr;
+        active_ = workers_;
+        ++generation_;
+    }
+    wake_.notify_all();
+    drain();
+
+    std::unique_lock lock(mutex_);
+    done_.wait(lock, [this] { return active_ == 0; });
+    invoke_ = nullptr;
+    task_ = nullptr;
+    if (error_) {
+        std::rethrow_exception(std::exchange(error_, nullptr));
+    }
+}
+
+inline ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+inline void ThreadPool::worker_loop() {
+    std::uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock lock(mutex_);
+            wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) {
+                return;
+            }
+            seen = generation_;
+        }
+        drain();
+        {
+            std::lock_guard lock(mutex_);
+            if (--active_ == 0) {
+                done_.notify_one();
+            }
+        }
+    }
+}
+
+inline void ThreadPool::drain() noexcept {
+    for (std::size_t i = next_.fetch_add(1, std::memory_order_relaxed); i < count_;
+         i = next_.fetch_add(1, std::memory_order_relaxed)) {
+        try {
+            invoke_(task_, i);
+        } catch (...) {
+            std::lock_guard lock(mutex_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+        }
+    }
+}
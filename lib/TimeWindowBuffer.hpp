@@ -0,0 +1,202 @@
+#pragma once
+
+#include "BufferChecks.hpp"
+#include "CircularBufferExt.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <utility>
+
+template<typename T, typename TimePoint>
+struct Timed {
+    TimePoint time;
+    T value;
+};
+
+// Keeps the entries of the last window() of time, oldest first. Expired entries are dropped in bulk whenever
+// the window moves - on push or on advance(now) - by scanning the contiguous segments from the front, so eviction
+// costs O(evicted). Passing the time in avoids a clock read per call; the overloads without it call Clock::now().
+template<typename T, typename Clock = std::chrono::steady_clock>
+class TimeWindowBuffer {
+public:
+    using clock = Clock;
+    using time_point = typename Clock::time_point;
+    using duration = typename Clock::duration;
+    using value_type = Timed<T, time_point>;
+    using buffer_type = CircularBufferExt<value_type>;
+    using size_type = typename buffer_type::size_type;
+    using const_iterator = typename buffer_type::const_iterator;
+
+    // max_count == 0 means no limit on the number of entries; otherwise the oldest entry is dropped when full.
+    explicit TimeWindowBuffer(duration window, size_type max_count = 0);
+
+    // Timestamps must not decrease between pushes.
+    void push(const T& value, time_point now);
+
+    void push(T&& value, time_point now);
+
+    template<typename... Args>
+    void emplace(time_point now, Args&& ... args);
+
+    void push(const T& value);
+
+    void push(T&& value);
+
+    // Drops every entry older than now - window(); returns how many were dropped.
+    size_type advance(time_point now);
+
+    size_type advance();
+
+    const value_type& front() const;
+
+    const value_type& back() const;
+
+    const_iterator begin() const noexcept;
+
+    const_iterator end() const noexcept;
+
+    // The underlying ring, e.g. for peek() or the sorted:: helpers keyed on &value_type::time.
+    const buffer_type& entries() const noexcept;
+
+    size_type size() const noexcept;
+
+    bool empty() const noexcept;
+
+    void clear() noexcept;
+
+    duration window() const noexcept;
+
+    size_type max_count() const noexcept;
+
+private:
+    // Makes room for one more entry stamped now.
+    void prepare_push(time_point now);
+
+    buffer_type buffer_;
+    duration window_;
+    size_type max_count_;
+};
+
+template<typename T, typename Clock>
+TimeWindowBuffer<T, Clock>::TimeWindowBuffer(duration window, size_type max_count)
+        : window_(window), max_count_(max_count) {
+    CIRCULAR_BUFFER_CHECK(window >= duration::zero(), "Window must not be negative");
+    if (max_count_ != 0) {
+        buffer_.reserve(max_count_);
+    }
+}
+
+template<typename T, typename Clock>
+void TimeWindowBuffer<T, Clock>::prepare_push(time_point now) {
+    CIRCULAR_BUFFER_CHECK(buffer_.empty() || buffer_.back().time <= now, "Timestamps must not decrease");
+    advance(now);
+    if (max_count_ != 0 && buffer_.size() == max_count_) {
+        buffer_.pop_front();
+    }
+}
+
+template<typename T, typename Clock>
+void TimeWindowBuffer<T, Clock>::push(const T& value, time_point now) {
+    prepare_push(now);
+    buffer_.push_back(value_type{now, value});
+}
+
+template<typename T, typename Clock>
+void TimeWindowBuffer<T, Clock>::push(T&& value, time_point now) {
+    prepare_push(now);
+    buffer_.push_back(value_type{now, std::move(value)});
+}
+
+template<typename T, typename Clock>
+template<typename... Args>
+void TimeWindowBuffer<T, Clock>::emplace(time_point now, Args&& ... args) {
+    prepare_push(now);
+    buffer_.push_back(value_type{now, T(std::forward<Args>(args)...)});
+}
+
+template<typename T, typename Clock>
+void TimeWindowBuffer<T, Clock>::push(const T& value) {
+    push(value, Clock::now());
+}
+
+template<typename T, typename Clock>
+void TimeWindowBuffer<T, Clock>::push(T&& value) {
+    push(std::move(value), Clock::now());
+}
+
+template<typename T, typename Clock>
+TimeWindowBuffer<T, Clock>::size_type TimeWindowBuffer<T, Clock>::advance(time_point now) {
+    if (buffer_.empty() || now - buffer_.front().time <= window_) {
+        return 0;
+    }
+    // Entries at exactly now - window are still inside the window.
+    const time_point oldest = now - window_;
+    const auto regions = buffer_.peek(buffer_.size());
+    size_type expired = 0;
+    for (const auto& segment: {regions.first, regions.second}) {
+        for (const value_type& entry: segment) {
+            if (entry.time >= oldest) {
+                buffer_.consume(expired);
+                return expired;
+            }
+            ++expired;
+        }
+    }
+    buffer_.consume(expired);
+    return expired;
+}
+
+template<typename T, typename Clock>
+TimeWindowBuffer<T, Clock>::size_type TimeWindowBuffer<T, Clock>::advance() {
+    return advance(Clock::now());
+}
+
+template<typename T, typename Clock>
+const TimeWindowBuffer<T, Clock>::value_type& TimeWindowBuffer<T, Clock>::front() const {
+    return buffer_.front();
+}
+
+template<typename T, typename Clock>
+const TimeWindowBuffer<T, Clock>::value_type& TimeWindowBuffer<T, Clock>::back() const {
+    return buffer_.back();
+}
+
+template<typename T, typename Clock>
+TimeWindowBuffer<T, Clock>::const_iterator TimeWindowBuffer<T, Clock>::begin() const noexcept {
+    return buffer_.cbegin();
+}
+
+template<typename T, typename Clock>
+TimeWindowBuffer<T, Clock>::const_iterator TimeWindowBuffer<T, Clock>::end() const noexcept {
+    return buffer_.cend();
+}
+
+template<typename T, typename Clock>
+const TimeWindowBuffer<T, Clock>::buffer_type& TimeWindowBuffer<T, Clock>::entries() const noexcept {
+    return buffer_;
+}
+
+template<typename T, typename Clock>
+TimeWindowBuffer<T, Clock>::size_type TimeWindowBuffer<T, Clock>::size() const noexcept {
+    return buffer_.size();
+}
+
+template<typename T, typename Clock>
+bool TimeWindowBuffer<T, Clock>::empty() const noexcept {
+    return buffer_.empty();
+}
+
+template<typename T, typename Clock>
+void TimeWindowBuffer<T, Clock>::clear() noexcept {
+    buffer_.clear();
+}
+
+template<typename T, typename Clock>
+TimeWindowBuffer<T, Clock>::duration TimeWindowBuffer<T, Clock>::window() const noexcept {
+    return window_;
+}
+
+template<typename T, typename Clock>
+TimeWindowBuffer<T, Clock>::size_type TimeWindowBuffer<T, Clock>::max_count() const noexcept {
+    return max_count_;
+}
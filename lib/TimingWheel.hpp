@@ -0,0 +1,258 @@
+#pragma once
+
+#include "BufferChecks.hpp"
+#include "CircularBuffer.hpp"
+#include "CircularBufferExt.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// Hierarchical timing wheel. Level L is a CircularBuffer of kSlots buckets, each spanning kSlots^L ticks; the
+// front bucket of level 0 is the current tick. Advancing a tick rotates level 0 by one bucket, and whenever a
+// level's front bucket starts, its timers cascade into the lower levels. Timers past the top level wait in its
+// last bucket and are re-placed when it comes round.
+//
+// Timers live in an index-linked node pool, so schedule() and cancel() are O(1) and handles carry a generation
+// that makes cancelling an already fired timer harmless.
+template<typename T, std::size_t Levels = 4>
+class TimingWheel {
+public:
+    static_assert(Levels >= 1 && Levels <= 8, "Each level takes 8 bits of the 64-bit tick");
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using tick_type = std::uint64_t;
+
+    static constexpr unsigned kSlotBits = 8;
+    static constexpr size_type kSlots = size_type{1} << kSlotBits;
+
+    struct Handle {
+        std::uint32_t index = kNil;
+        std::uint32_t generation = 0;
+    };
+
+    explicit TimingWheel(tick_type now = 0);
+
+    // Runs value's timer at tick `deadline`; deadlines not after now() fire on the next tick.
+    Handle schedule(tick_type deadline, T value);
+
+    // false if the timer already fired or was cancelled.
+    bool cancel(Handle handle);
+
+    // Moves the clock to `to`, calling on_expire(value) for every timer that comes due, one bucket per tick.
+    // Stretches without timers in the lower levels are skipped. Returns the number of timers fired.
+    template<typename F>
+    size_type advance(tick_type to, F&& on_expire);
+
+    tick_type now() const noexcept;
+
+    size_type size() const noexcept;
+
+    bool empty() const noexcept;
+
+private:
+    static constexpr std::uint32_t kNil = ~std::uint32_t{0};
+
+    struct Node {
+        T value;
+        tick_type deadline;
+        // Absolute bucket number within `level`.
+        tick_type bucket;
+        std::uint32_t prev;
+        std::uint32_t next;
+        std::uint32_t generation;
+        std::uint32_t level;
+    };
+
+    static constexpr std::uint32_t kFree = Levels;
+
+    // First absolute bucket number of a level's ring.
+    tick_type base(size_type level) const noexcept;
+
+    std::uint32_t& head(size_type level, tick_type bucket);
+
+    void place(std::uint32_t index);
+
+    void unlink(std::uint32_t index);
+
+    void release(std::uint32_t index);
+
+    CircularBuffer<std::uint32_t> rings_[Levels];
+    size_type counts_[Levels] = {};
+    CircularBufferExt<Node> nodes_;
+    std::uint32_t free_ = kNil;
+    size_type size_ = 0;
+    tick_type now_;
+};
+
+
+template<typename T, std::size_t Levels>
+TimingWheel<T, Levels>::TimingWheel(tick_type now) : now_(now) {
+    for (auto& ring: rings_) {
+        ring = CircularBuffer<std::uint32_t>(kSlots);
+        for (size_type i = 0; i < kSlots; ++i) {
+            ring.push_back(kNil);
+        }
+    }
+}
+
+template<typename T, std::size_t Levels>
+TimingWheel<T, Levels>::tick_type TimingWheel<T, Levels>::base(size_type level) const noexcept {
+    // Level 0 starts at the current tick; level L at the first whole kSlots^L span after it.
+    return level == 0 ? now_ : (now_ >> (kSlotBits * level)) + 1;
+}
+
+template<typename T, std::size_t Levels>
+std::uint32_t& TimingWheel<T, Levels>::head(size_type level, tick_type bucket) {
+    return rings_[level][static_cast<size_type>(bucket - base(level))];
+}
+
+template<typename T, std::size_t Levels>
+void TimingWheel<T, Levels>::place(std::uint32_t index) {
+    Node& node = nodes_[index];
+    std::uint32_t level = 0;
+    tick_type bucket = node.deadline;
+    if (node.deadline - now_ >= kSlots) {
+        for (level = 1;; ++level) {
+            bucket = node.deadline >> (kSlotBits * level);
+            if (bucket - base(level) < kSlots) {
+                break;
+            }
+            if (level == Levels - 1) {
+                bucket = base(level) + kSlots - 1;
+                break;
+            }
+        }
+    }
+    node.level = level;
+    node.bucket = bucket;
+    std::uint32_t& first = head(level, bucket);
+    node.prev = kNil;
+    node.next = first;
+    if (first != kNil) {
+        nodes_[first].prev = index;
+    }
+    first = index;
+    ++counts_[level];
+}
+
+template<typename T, std::size_t Levels>
+void TimingWheel<T, Levels>::unlink(std::uint32_t index) {
+    Node& node = nodes_[index];
+    if (node.prev == kNil) {
+        head(node.level, node.bucket) = node.next;
+    } else {
+        nodes_[node.prev].next = node.next;
+    }
+    if (node.next != kNil) {
+        nodes_[node.next].prev = node.prev;
+    }
+    --counts_[node.level];
+}
+
+template<typename T, std::size_t Levels>
+void TimingWheel<T, Levels>::release(std::uint32_t index) {
+    Node& node = nodes_[index];
+    node.level = kFree;
+    ++node.generation;
+    node.next = free_;
+    free_ = index;
+    --size_;
+}
+
+template<typename T, std::size_t Levels>
+TimingWheel<T, Levels>::Handle TimingWheel<T, Levels>::schedule(tick_type deadline, T value) {
+    std::uint32_t index = free_;
+    if (index != kNil) {
+        free_ = nodes_[index].next;
+        nodes_[index].value = std::move(value);
+    } else {
+        CIRCULAR_BUFFER_CHECK(nodes_.size() < kNil, "Too many timers");
+        index = static_cast<std::uint32_t>(nodes_.size());
+        nodes_.push_back(Node{std::move(value), 0, 0, kNil, kNil, 0, kFree});
+    }
+    nodes_[index].deadline = std::max(deadline, now_ + 1);
+    place(index);
+    ++size_;
+    return Handle{index, nodes_[index].generation};
+}
+
+template<typename T, std::size_t Levels>
+bool TimingWheel<T, Levels>::cancel(Handle handle) {
+    if (handle.index >= nodes_.size()) {
+        return false;
+    }
+    const Node& node = nodes_[handle.index];
+    if (node.level == kFree || node.generation != handle.generation) {
+        return false;
+    }
+    unlink(handle.index);
+    release(handle.index);
+    return true;
+}
+
+template<typename T, std::size_t Levels>
+template<typename F>
+TimingWheel<T, Levels>::size_type TimingWheel<T, Levels>::advance(tick_type to, F&& on_expire) {
+    size_type fired = 0;
+    while (now_ < to) {
+        // With levels below `empty_levels` empty, ticks up to the next rotation of that level change nothing.
+        size_type empty_levels = 0;
+        while (empty_levels < Levels && counts_[empty_levels] == 0) {
+            ++empty_levels;
+        }
+        if (empty_levels == Levels) {
+            now_ = to;
+            break;
+        }
+        if (empty_levels != 0) {
+            const tick_type span_end = now_ | ((tick_type{1} << (kSlotBits * empty_levels)) - 1);
+            now_ = std::min(to - 1, span_end);
+        }
+
+        ++now_;
+        std::uint32_t cascading[Levels];
+        size_type rotated = 1;
+        rings_[0].pop_front();
+        rings_[0].push_back(kNil);
+        for (; rotated < Levels && (now_ & ((tick_type{1} << (kSlotBits * rotated)) - 1)) == 0; ++rotated) {
+            cascading[rotated] = rings_[rotated].pop_front();
+            rings_[rotated].push_back(kNil);
+        }
+        // Buckets that just started only hold timers due before the next bucket of the level below.
+        for (size_type level = rotated; level-- > 1;) {
+            for (std::uint32_t index = cascading[level]; index != kNil;) {
+                const std::uint32_t next = nodes_[index].next;
+                --counts_[level];
+                place(index);
+                index = next;
+            }
+        }
+
+        for (std::uint32_t index = rings_[0].front(); index != kNil; index = rings_[0].front()) {
+            unlink(index);
+            T value = std::move(nodes_[index].value);
+            release(index);
+            ++fired;
+            on_expire(value);
+        }
+    }
+    return fired;
+}
+
+template<typename T, std::size_t Levels>
+TimingWheel<T, Levels>::tick_type TimingWheel<T, Levels>::now() const noexcept {
+    return now_;
+}
+
+template<typename T, std::size_t Levels>
+TimingWheel<T, Levels>::size_type TimingWheel<T, Levels>::size() const noexcept {
+    return size_;
+}
+
+template<typename T, std::size_t Levels>
+bool TimingWheel<T, Levels>::empty() const noexcept {
+    return size_ == 0;
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+// Lock-free Chase-Lev deque (with the memory orderings of Le et al., "Correct and Efficient Work-Stealing for
+// Weak Memory Models"). The owner thread pushes and pops at the bottom like a stack; any other thread steals
+// from the top with a CAS. When full, the owner copies the live range into an array twice the size; the old
+// array is kept until the deque dies, so a thief still reading it never sees freed memory.
+template<typename T>
+class WorkStealingDeque {
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "Slots are read by thieves that may lose the race for them");
+
+    using value_type = T;
+    using size_type = std::size_t;
+
+    // capacity is rounded up to a power of two.
+    explicit WorkStealingDeque(size_type capacity = 64);
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    ~WorkStealingDeque();
+
+    // Owner only.
+    void push(const T& value);
+
+    // Owner only; the most recently pushed element.
+    std::optional<T> pop() noexcept;
+
+    // Any thread; the oldest element. Also returns nullopt when another thread took it first.
+    std::optional<T> steal() noexcept;
+
+    // Only a hint while other threads are active.
+    size_type size() const noexcept;
+
+    bool empty() const noexcept;
+
+    size_type capacity() const noexcept;
+
+private:
+    struct Array {
+        explicit Array(size_type capacity)
+                : mask(capacity - 1), slots(std::make_unique<std::atomic<T>[]>(capacity)) {}
+
+        T get(std::int64_t index) const noexcept {
+            return slots[static_cast<size_type>(index) & mask].load(std::memory_order_relaxed);
+        }
+
+        void put(std::int64_t index, const T& value) noexcept {
+            slots[static_cast<size_type>(index) & mask].store(value, std::memory_order_relaxed);
+        }
+
+        size_type mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+        // The array this one replaced; kept alive for thieves that loaded it before the swap.
+        std::unique_ptr<Array> retired;
+    };
+
+    alignas(64) std::atomic<std::int64_t> top_{0};
+    alignas(64) std::atomic<std::int64_t> bottom_{0};
+    std::atomic<Array*> array_;
+};
+
+
+template<typename T>
+WorkStealingDeque<T>::WorkStealingDeque(size_type capacity)
+        : array_(new Array(std::bit_ceil(std::max<size_type>(capacity, 2)))) {}
+
+template<typename T>
+WorkStealingDeque<T>::~WorkStealingDeque() {
+    delete array_.load(std::memory_order_relaxed);
+}
+
+template<typename T>
+void WorkStealingDeque<T>::push(const T& value) {
+    const std::int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    const std::int64_t top = top_.load(std::memory_order_acquire);
+    Array* array = array_.load(std::memory_order_relaxed);
+    if (static_cast<size_type>(bottom - top) > array->mask) {
+        auto grown = std::make_unique<Array>(2 * (array->mask + 1));
+        for (std::int64_t i = top; i < bottom; ++i) {
+            grown->put(i, array->get(i));
+        }
+        grown->retired.reset(array);
+        array = grown.release();
+        array_.store(array, std::memory_order_release);
+    }
+    array->put(bottom, value);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+}
+
+template<typename T>
+std::optional<T> WorkStealingDeque<T>::pop() noexcept {
+    const std::int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    Array* array = array_.load(std::memory_order_relaxed);
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t top = top_.load(std::memory_order_relaxed);
+
+    if (top > bottom) {
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+    const T value = array->get(bottom);
+    if (top == bottom) {
+        // Last element: race the thieves for it.
+        const bool won = top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                                      std::memory_order_relaxed);
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+        if (!won) {
+            return std::nullopt;
+        }
+    }
+    return value;
+}
+
+template<typename T>
+std::optional<T> WorkStealingDeque<T>::steal() noexcept {
+    std::int64_t top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const std::int64_t bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom) {
+        return std::nullopt;
+    }
+    const T value = array_.load(std::memory_order_acquire)->get(top);
+    if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+template<typename T>
+WorkStealingDeque<T>::size_type WorkStealingDeque<T>::size() const noexcept {
+    const std::int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    const std::int64_t top = top_.load(std::memory_order_relaxed);
+    return bottom > top ? static_cast<size_type>(bottom - top) : 0;
+}
+
+template<typename T>
+bool WorkStealingDeque<T>::empty() const noexcept {
+    return size() == 0;
+}
+
+template<typename T>
+WorkStealingDeque<T>::size_type WorkStealingDeque<T>::capacity() const noexcept {
+    return array_.load(std::memory_order_relaxed)->mask + 1;
+}
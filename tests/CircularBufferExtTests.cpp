@@ -2,6 +2,7 @@
 
 #include <gtest/gtest.h>
 
+#include <cstring>
 #include <string>
 
 
@@ -224,3 +225,154 @@ TEST(BACK_EXT, SIMPLE_TEST) {
 
     ASSERT_TRUE(cb.back() == 4);
 }
+
+TEST(PREPARE_TEST_EXT, PREPARE_COMMIT_PEEK_CONSUME) {
+    CircularBufferExt<int> cb(4);
+    cb.push_back(1);
+
+    auto free = cb.prepare(2);
+    ASSERT_EQ(free.size(), 2);
+    free.first[0] = 2;
+    free.first[1] = 3;
+    cb.commit(2);
+
+    auto data = cb.peek(cb.size());
+    ASSERT_EQ(data.first.size(), 3);
+    ASSERT_EQ(data.first[2], 3);
+
+    cb.consume(2);
+    ASSERT_TRUE(cb == CircularBufferExt<int>({3}));
+}
+
+TEST(SNAPSHOT_TEST_EXT, ROUND_TRIP_THEN_GROW) {
+    CircularBufferExt<double> cb = {1.5, 2.5, 3.5};
+    std::string bytes;
+    cb.save([&](std::span<const std::byte> data) {
+        bytes.append(reinterpret_cast<const char*>(data.data()), data.size());
+    });
+
+    CircularBufferExt<double> restored;
+    std::size_t offset = 0;
+    restored.load([&](std::span<std::byte> out) {
+        std::memcpy(out.data(), bytes.data() + offset, out.size());
+        offset += out.size();
+    });
+    ASSERT_TRUE(restored == cb);
+
+    restored.push_back(4.5);
+    ASSERT_TRUE(restored == CircularBufferExt<double>({1.5, 2.5, 3.5, 4.5}));
+}
+
+TEST(STATS_TEST_EXT, COUNTS_GROWTH_AND_MOVED_ELEMENTS) {
+    CircularBufferExt<int, 2, std::allocator<int>, BufferStats> cb(2);
+    for (int i = 0; i < 5; ++i) {
+        cb.push_back(i);
+    }
+    cb.assign({1});
+    cb.shrink_to_fit();
+
+    const auto& stats = cb.stats();
+    ASSERT_EQ(stats.pushes(), 5);
+    ASSERT_EQ(stats.growths(), 2);
+    ASSERT_EQ(stats.elements_moved(), 2 + 4 + 1);
+    ASSERT_EQ(stats.shrinks(), 1);
+    ASSERT_EQ(stats.peak_size(), 5);
+    ASSERT_EQ(stats.footprint_bytes(), 2 * sizeof(int));
+}
+
+TEST(POP_INTO_TEST_EXT, DRAIN_WITH_POP_FRONT_INTO) {
+    CircularBufferExt<int> cb;
+    for (int i = 0; i < 10; ++i) {
+        cb.push_back(i);
+    }
+
+    int sum = 0;
+    for (int value; cb.pop_front_into(value);) {
+        sum += value;
+    }
+    ASSERT_EQ(sum, 45);
+    ASSERT_TRUE(cb.empty());
+}
+
+TEST(TRY_API_TEST_EXT, TRY_PUSH_DOES_NOT_GROW) {
+    CircularBufferExt<int> cb(2);
+
+    ASSERT_TRUE(cb.try_push_back(1));
+    ASSERT_TRUE(cb.try_push_back(2));
+    ASSERT_FALSE(cb.try_push_back(3));
+    ASSERT_EQ(cb.capacity(), 2);
+
+    cb.push_back(3);
+    ASSERT_EQ(cb.capacity(), 4);
+    ASSERT_TRUE(cb.try_push_front(0));
+    ASSERT_TRUE(cb == CircularBufferExt<int>({0, 1, 2, 3}));
+}
+
+TEST(ERASE_IF_TEST_EXT, COMPACTS_ACROSS_WRAP) {
+    CircularBufferExt<int> cb(8);
+    for (int i = 0; i < 5; ++i) {
+        cb.push_back(-1);
+        cb.pop_front();
+    }
+    for (int i = 0; i < 8; ++i) {
+        cb.push_back(i);
+    }
+
+    ASSERT_EQ(cb.erase_if([](int value) { return value % 3 == 0; }), 3);
+    ASSERT_TRUE(cb == CircularBufferExt<int>({1, 2, 4, 5, 7}));
+    ASSERT_EQ(cb.erase_if([](int) { return false; }), 0);
+    ASSERT_EQ(cb.erase_if([](int) { return true; }), 5);
+    ASSERT_TRUE(cb.empty());
+}
+
+TEST(ERASE_IF_TEST_EXT, RETAIN_NON_TRIVIAL) {
+    CircularBufferExt<std::string> cb;
+    for (int i = 0; i < 10; ++i) {
+        cb.push_front(std::string(i + 1, 'x'));
+    }
+
+    ASSERT_EQ(cb.retain([](const std::string& s) { return s.size() % 2 == 0; }), 5);
+    ASSERT_EQ(cb.size(), 5);
+    ASSERT_EQ(cb.front(), std::string(10, 'x'));
+    ASSERT_EQ(cb.back(), std::string(2, 'x'));
+}
+
+TEST(PMR_TEST_EXT, EQUAL_ALLOCATORS_STEAL_STORAGE) {
+    std::pmr::monotonic_buffer_resource arena;
+    pmr::CircularBufferExt<int> a(&arena);
+    pmr::CircularBufferExt<int> b(&arena);
+    for (int i = 0; i < 10; ++i) {
+        a.push_back(i);
+    }
+    b.push_back(42);
+    const int* a_data = &a.front();
+    const int* b_data = &b.front();
+
+    a.swap(b);
+    ASSERT_EQ(&a.front(), b_data);
+    ASSERT_EQ(&b.front(), a_data);
+
+    pmr::CircularBufferExt<int> c(&arena);
+    c = std::move(b);
+    ASSERT_EQ(&c.front(), a_data);
+    ASSERT_EQ(c.size(), 10);
+    ASSERT_EQ(c.get_allocator().resource(), &arena);
+}
+
+TEST(PMR_TEST_EXT, DIFFERENT_RESOURCES_MOVE_ELEMENTS) {
+    std::pmr::monotonic_buffer_resource first;
+    std::pmr::unsynchronized_pool_resource second;
+    pmr::CircularBufferExt<std::string> a(&first);
+    pmr::CircularBufferExt<std::string> b(&second);
+    a.push_back("left");
+    b.push_back("right");
+
+    a.swap(b);
+    ASSERT_EQ(a.front(), "right");
+    ASSERT_EQ(b.front(), "left");
+    ASSERT_EQ(a.get_allocator().resource(), &first);
+
+    b = std::move(a);
+    ASSERT_EQ(b.front(), "right");
+    ASSERT_EQ(b.get_allocator().resource(), &second);
+}
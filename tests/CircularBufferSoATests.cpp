@@ -0,0 +1,136 @@
+#include "lib/CircularBufferSoA.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory_resource>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+
+namespace {
+
+struct ThrowingField {
+    explicit ThrowingField(int value) : value(value) {
+        if (value < 0) {
+            throw std::runtime_error("negative field");
+        }
+    }
+
+    int value;
+};
+
+} // namespace
+
+TEST(SOA_TEST, PUSH_OVERWRITES_LIKE_CIRCULAR_BUFFER) {
+    CircularBufferSoA<std::int64_t, double> cb(3);
+    for (int i = 0; i < 5; ++i) {
+        cb.push_back(i, i * 0.5);
+    }
+    ASSERT_EQ(cb.size(), 3);
+    ASSERT_EQ(std::get<0>(cb.front()), 2);
+    ASSERT_EQ(std::get<1>(cb.back()), 2.0);
+
+    cb.push_front(-1, -0.5);
+    ASSERT_EQ(std::get<0>(cb.front()), -1);
+    ASSERT_EQ(std::get<0>(cb.back()), 3);
+
+    ASSERT_EQ(cb.pop_front(), std::make_tuple(std::int64_t{-1}, -0.5));
+    ASSERT_EQ(cb.pop_back(), std::make_tuple(std::int64_t{3}, 1.5));
+    ASSERT_EQ(cb.size(), 1);
+    ASSERT_THROW({
+        cb.pop_back();
+        cb.pop_back();
+    }, std::out_of_range);
+}
+
+TEST(SOA_TEST, COLUMN_SEGMENTS_ACROSS_WRAP) {
+    CircularBufferSoA<std::int64_t, double, std::uint8_t> cb(8);
+    for (int i = 0; i < 13; ++i) {
+        cb.push_back(i, i * 2.0, static_cast<std::uint8_t>(i % 2));
+    }
+
+    const auto prices = cb.column<1>();
+    ASSERT_EQ(prices.size(), 8);
+    ASSERT_FALSE(prices.second.empty());
+    const double sum = std::accumulate(prices.first.begin(), prices.first.end(), 0.0) +
+                       std::accumulate(prices.second.begin(), prices.second.end(), 0.0);
+    ASSERT_EQ(sum, 2.0 * (5 + 6 + 7 + 8 + 9 + 10 + 11 + 12));
+
+    auto flags = cb.column<2>();
+    std::fill(flags.first.begin(), flags.first.end(), 7);
+    std::fill(flags.second.begin(), flags.second.end(), 7);
+    for (const auto& [timestamp, price, flag]: cb) {
+        ASSERT_EQ(price, timestamp * 2.0);
+        ASSERT_EQ(flag, 7);
+    }
+}
+
+TEST(SOA_TEST, PROXY_REFERENCES_WRITE_THROUGH) {
+    CircularBufferSoA<int, std::string> cb(4);
+    cb.push_back(1, "one");
+    cb.push_back(2, "two");
+    cb.push_back(3, "three");
+
+    for (auto row: cb) {
+        std::get<0>(row) *= 10;
+    }
+    std::get<1>(cb[1]) = "deux";
+    auto it = cb.begin() + 2;
+    ASSERT_EQ(it - cb.begin(), 2);
+    ASSERT_EQ(std::get<0>(*it), 30);
+    ASSERT_EQ(std::get<1>(cb.cbegin()[1]), "deux");
+    ASSERT_EQ(std::count_if(cb.begin(), cb.end(), [](auto row) { return std::get<0>(row) > 10; }), 2);
+
+    CircularBufferSoA<int, std::string> moved(std::move(cb));
+    ASSERT_EQ(moved.size(), 3);
+    ASSERT_TRUE(cb.empty());
+}
+
+TEST(SOA_TEST, THROWING_FIELD_LEAVES_NO_TRACE) {
+    CircularBufferSoA<std::string, ThrowingField> cb(2);
+    const std::string long_a(64, 'a');
+    const std::string long_b(64, 'b');
+    cb.push_back(long_a, 1);
+
+    ASSERT_THROW(cb.push_back(std::string(64, 'x'), -1), std::runtime_error);
+    ASSERT_THROW(cb.push_front(std::string(64, 'x'), -1), std::runtime_error);
+    ASSERT_EQ(cb.size(), 1);
+
+    cb.push_back(long_b, 2);
+    ASSERT_THROW(cb.push_back(std::string(64, 'x'), -1), std::runtime_error);
+    ASSERT_THROW(cb.push_front(std::string(64, 'x'), -1), std::runtime_error);
+    ASSERT_EQ(cb.size(), 2);
+    ASSERT_EQ(std::get<0>(cb.front()), long_a);
+    ASSERT_EQ(std::get<1>(cb.front()).value, 1);
+    ASSERT_EQ(std::get<0>(cb.back()), long_b);
+    ASSERT_EQ(std::get<1>(cb.back()).value, 2);
+}
+
+TEST(SOA_TEST, PMR_COLUMNS_COME_FROM_THE_RESOURCE) {
+    std::pmr::monotonic_buffer_resource arena;
+    std::pmr::unsynchronized_pool_resource pool;
+    pmr::CircularBufferSoA<std::int64_t, std::pmr::string> a(4, &arena);
+    ASSERT_EQ(a.get_allocator().resource(), &arena);
+    a.push_back(1, std::string(64, 'a'));
+    a.push_back(2, std::string(64, 'b'));
+    ASSERT_EQ(std::get<1>(a.front()).get_allocator().resource(), &arena);
+
+    pmr::CircularBufferSoA<std::int64_t, std::pmr::string> b(2, &pool);
+    b.push_back(3, "c");
+    b = std::move(a);
+    ASSERT_EQ(b.get_allocator().resource(), &pool);
+    ASSERT_EQ(b.capacity(), 4);
+    ASSERT_EQ(b.size(), 2);
+    ASSERT_EQ(std::get<0>(b.front()), 1);
+    ASSERT_EQ(std::get<1>(b.back()), std::pmr::string(64, 'b'));
+    ASSERT_EQ(std::get<1>(b.back()).get_allocator().resource(), &pool);
+    ASSERT_TRUE(a.empty());
+
+    pmr::CircularBufferSoA<std::int64_t, std::pmr::string> c(1, &pool);
+    c = std::move(b);
+    ASSERT_EQ(c.capacity(), 4);
+    ASSERT_EQ(std::get<1>(c.front()), std::pmr::string(64, 'a'));
+}
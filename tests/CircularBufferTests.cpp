@@ -1,8 +1,15 @@
+#include "lib/CacheAligned.hpp"
 #include "lib/CircularBuffer.hpp"
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <sstream>
 #include <string>
+#include <vector>
 
 
 TEST(PUSH_TEST, ALTERNATING_PUSH) {
@@ -109,6 +116,64 @@ TEST(ASSIGN_TEST, INITIALIZER_LIST) {
     ASSERT_TRUE(cb == CircularBuffer<int>({1, 2, 3, 4, 5}));
 }
 
+TEST(ASSIGN_TEST, REUSES_STORAGE_ACROSS_WRAP) {
+    CircularBuffer<std::string, std::allocator<std::string>, BufferStats> cb(4);
+    for (int i = 0; i < 6; ++i) {
+        cb.push_back(std::to_string(i));
+    }
+
+    cb.assign({"a", "b"});
+    ASSERT_TRUE(std::equal(cb.begin(), cb.end(), std::vector<std::string>{"a", "b"}.begin()));
+    cb.assign(3, "c");
+    ASSERT_TRUE(std::equal(cb.begin(), cb.end(), std::vector<std::string>{"c", "c", "c"}.begin()));
+    ASSERT_EQ(cb.size(), 3);
+
+    ASSERT_EQ(cb.capacity(), 4);
+    ASSERT_EQ(cb.stats().growths() + cb.stats().shrinks(), 0);
+
+    cb.assign(5, "d");
+    ASSERT_EQ(cb.capacity(), 5);
+    ASSERT_EQ(cb.stats().growths(), 1);
+}
+
+TEST(ASSIGN_TEST, COPY_KEEPS_CAPACITY) {
+    CircularBuffer<int, std::allocator<int>, BufferStats> source(8);
+    source.push_back(1);
+    source.push_back(2);
+
+    auto copy = source;
+    ASSERT_EQ(copy.capacity(), 8);
+
+    CircularBuffer<int, std::allocator<int>, BufferStats> target(16);
+    for (int i = 0; i < 20; ++i) {
+        target.push_back(i);
+    }
+    target = source;
+    ASSERT_EQ(target.capacity(), 16);
+    ASSERT_EQ(target.stats().growths() + target.stats().shrinks(), 0);
+    ASSERT_TRUE(target == source);
+    target.push_back(3);
+    ASSERT_EQ(target.back(), 3);
+    ASSERT_EQ(target.size(), 3);
+}
+
+TEST(ASSIGN_TEST, SHRINK_TO_FIT) {
+    CircularBuffer<std::string, std::allocator<std::string>, BufferStats> cb(10);
+    for (int i = 0; i < 13; ++i) {
+        cb.push_back(std::to_string(i));
+    }
+    cb.consume(7);
+
+    cb.shrink_to_fit();
+    ASSERT_EQ(cb.capacity(), 3);
+    ASSERT_TRUE(std::equal(cb.begin(), cb.end(), std::vector<std::string>{"10", "11", "12"}.begin()));
+    ASSERT_EQ(cb.stats().shrinks(), 1);
+    ASSERT_EQ(cb.stats().elements_moved(), 3);
+
+    cb.shrink_to_fit();
+    ASSERT_EQ(cb.stats().shrinks(), 1);
+}
+
 TEST(RESERVE_TEST, SIMPLE_TEST) {
     CircularBuffer<int> cb = {1, 2, 3, 4, 5};
     CircularBuffer<int> copy = cb;
@@ -214,3 +279,345 @@ TEST(BACK, SIMPLE_TEST) {
 
     ASSERT_TRUE(cb.back() == 4);
 }
+
+TEST(PREPARE_TEST, WRITE_IN_PLACE_ACROSS_WRAP) {
+    CircularBuffer<int> cb(5);
+    cb.push_back(1);
+    cb.push_back(2);
+    cb.push_back(3);
+    cb.pop_front();
+    cb.pop_front();
+
+    auto regions = cb.prepare(10);
+    ASSERT_EQ(regions.size(), 4);
+    ASSERT_FALSE(regions.second.empty());
+    int value = 4;
+    for (int& slot : regions.first) {
+        slot = value++;
+    }
+    for (int& slot : regions.second) {
+        slot = value++;
+    }
+    cb.commit(regions.size());
+
+    ASSERT_TRUE(cb == CircularBuffer<int>({3, 4, 5, 6, 7}));
+}
+
+TEST(PREPARE_TEST, COMMIT_MORE_THAN_FREE) {
+    CircularBuffer<int> cb(2);
+    cb.push_back(1);
+
+    ASSERT_THROW(cb.commit(2), std::out_of_range);
+}
+
+TEST(PEEK_TEST, READ_AND_CONSUME) {
+    CircularBuffer<std::string> cb(4);
+    for (const char* s : {"a", "b", "c", "d", "e", "f"}) {
+        cb.push_back(s);
+    }
+
+    auto regions = cb.peek(3);
+    ASSERT_EQ(regions.size(), 3);
+    std::string joined;
+    for (const auto& s : regions.first) {
+        joined += s;
+    }
+    for (const auto& s : regions.second) {
+        joined += s;
+    }
+    ASSERT_EQ(joined, "cde");
+
+    cb.consume(3);
+    ASSERT_TRUE(cb == CircularBuffer<std::string>({"f"}));
+    ASSERT_THROW(cb.consume(2), std::out_of_range);
+}
+
+TEST(SNAPSHOT_TEST, TRIVIAL_ROUND_TRIP_KEEPS_CAPACITY) {
+    CircularBuffer<int> cb(5);
+    for (int i = 0; i < 8; ++i) {
+        cb.push_back(i);
+    }
+    std::string bytes;
+    cb.save([&](std::span<const std::byte> data) {
+        bytes.append(reinterpret_cast<const char*>(data.data()), data.size());
+    });
+    ASSERT_EQ(bytes.size(), sizeof(CircularBufferSnapshotHeader) + 5 * sizeof(int));
+
+    CircularBuffer<int> restored(1);
+    std::size_t offset = 0;
+    restored.load([&](std::span<std::byte> out) {
+        std::memcpy(out.data(), bytes.data() + offset, out.size());
+        offset += out.size();
+    });
+
+    ASSERT_EQ(restored.capacity(), 5);
+    ASSERT_TRUE(restored == CircularBuffer<int>({3, 4, 5, 6, 7}));
+    restored.push_back(8);
+    ASSERT_TRUE(restored == CircularBuffer<int>({4, 5, 6, 7, 8}));
+}
+
+TEST(SNAPSHOT_TEST, ELEMENT_HOOKS) {
+    CircularBuffer<std::string> cb(3);
+    cb.push_back("alpha");
+    cb.push_back("");
+    cb.push_back("gamma");
+
+    std::string bytes;
+    auto writer = [&](std::span<const std::byte> data) {
+        bytes.append(reinterpret_cast<const char*>(data.data()), data.size());
+    };
+    cb.save(writer, [](auto& write, const std::string& s) {
+        const std::uint64_t length = s.size();
+        write(std::as_bytes(std::span(&length, 1)));
+        write(std::as_bytes(std::span(s.data(), s.size())));
+    });
+
+    std::size_t offset = 0;
+    auto reader = [&](std::span<std::byte> out) {
+        std::memcpy(out.data(), bytes.data() + offset, out.size());
+        offset += out.size();
+    };
+    CircularBuffer<std::string> restored;
+    restored.load(reader, [](auto& read) {
+        std::uint64_t length;
+        read(std::as_writable_bytes(std::span(&length, 1)));
+        std::string s(length, '\0');
+        read(std::as_writable_bytes(std::span(s.data(), s.size())));
+        return s;
+    });
+
+    ASSERT_EQ(offset, bytes.size());
+    ASSERT_TRUE(restored == cb);
+}
+
+TEST(SNAPSHOT_TEST, REJECTS_FOREIGN_DATA) {
+    const std::string bytes(sizeof(CircularBufferSnapshotHeader), 'x');
+    CircularBuffer<int> cb(2);
+
+    ASSERT_THROW(cb.load([&](std::span<std::byte> out) {
+        std::memcpy(out.data(), bytes.data(), out.size());
+    }), std::invalid_argument);
+}
+
+TEST(STATS_TEST, NO_STATS_TAKE_NO_SPACE) {
+    static_assert(sizeof(CircularBuffer<int>) == 4 * sizeof(int*));
+    SUCCEED();
+}
+
+TEST(STATS_TEST, COUNTS_PUSHES_POPS_AND_OVERWRITES) {
+    CircularBuffer<int, std::allocator<int>, BufferStats> cb(3);
+    for (int i = 0; i < 5; ++i) {
+        cb.push_back(i);
+    }
+    cb.push_front(10);
+    cb.pop_back();
+    cb.consume(1);
+
+    const auto& stats = cb.stats();
+    ASSERT_EQ(stats.pushes(), 6);
+    ASSERT_EQ(stats.overwrites(), 3);
+    ASSERT_EQ(stats.pops(), 2);
+    ASSERT_EQ(stats.peak_size(), 3);
+    ASSERT_EQ(stats.footprint_bytes(), 4 * sizeof(int));
+
+    std::ostringstream out;
+    stats.dump(out, "quotes");
+    ASSERT_NE(out.str().find("quotes_overwrites 3\n"), std::string::npos);
+}
+
+TEST(POP_INTO_TEST, MOVES_INTO_CALLER_OBJECT) {
+    CircularBuffer<std::string> cb = {"front", "middle", "back"};
+    std::string out = "unchanged";
+
+    ASSERT_TRUE(cb.pop_front_into(out));
+    ASSERT_EQ(out, "front");
+    ASSERT_TRUE(cb.pop_back_into(out));
+    ASSERT_EQ(out, "back");
+    ASSERT_TRUE(cb.pop_back_into(out));
+    ASSERT_EQ(out, "middle");
+
+    out = "unchanged";
+    ASSERT_FALSE(cb.pop_front_into(out));
+    ASSERT_FALSE(cb.pop_back_into(out));
+    ASSERT_EQ(out, "unchanged");
+}
+
+TEST(POP_INTO_TEST, CONSUME_FRONT_IN_PLACE) {
+    CircularBuffer<std::string> cb(2);
+    cb.push_back("a");
+    cb.push_back("b");
+    cb.push_back("c");
+
+    std::string seen;
+    while (cb.consume_front([&](std::string& s) { seen += s; })) {}
+    ASSERT_EQ(seen, "bc");
+    ASSERT_TRUE(cb.empty());
+
+    cb.push_back("kept");
+    ASSERT_THROW(cb.consume_front([](std::string&) { throw std::runtime_error("fail"); }), std::runtime_error);
+    ASSERT_EQ(cb.front(), "kept");
+}
+
+TEST(TRY_API_TEST, EMPTY_BUFFER_DOES_NOT_THROW) {
+    CircularBuffer<std::string> cb(2);
+
+    ASSERT_EQ(cb.try_front(), nullptr);
+    ASSERT_EQ(cb.try_back(), nullptr);
+    ASSERT_FALSE(cb.try_pop_front().has_value());
+    ASSERT_FALSE(cb.try_pop_back().has_value());
+    ASSERT_EQ(cb.try_erase(cb.cbegin()).error(), BufferError::out_of_range);
+}
+
+TEST(TRY_API_TEST, TRY_PUSH_NEVER_OVERWRITES) {
+    CircularBuffer<std::string> cb(2);
+
+    ASSERT_TRUE(cb.try_push_back("b"));
+    ASSERT_TRUE(cb.try_push_front("a"));
+    ASSERT_FALSE(cb.try_push_back("c"));
+    ASSERT_FALSE(cb.try_emplace_back(3, 'c'));
+    ASSERT_TRUE(cb == CircularBuffer<std::string>({"a", "b"}));
+
+    ASSERT_EQ(*cb.try_front(), "a");
+    ASSERT_EQ(*cb.try_back(), "b");
+    ASSERT_EQ(cb.try_pop_back(), "b");
+    ASSERT_TRUE(cb.try_emplace_back(3, 'c'));
+    ASSERT_EQ(cb.try_pop_front(), "a");
+    ASSERT_EQ(cb.try_pop_front(), "ccc");
+}
+
+TEST(TRY_API_TEST, TRY_INSERT_AND_ERASE) {
+    CircularBuffer<int> cb = {1, 2, 4};
+    CircularBuffer<int> other = {7};
+
+    auto inserted = cb.try_insert(cb.cbegin() + 2, 3);
+    ASSERT_TRUE(inserted.has_value());
+    ASSERT_EQ(**inserted, 3);
+    ASSERT_TRUE(cb == CircularBuffer<int>({1, 2, 3, 4}));
+    ASSERT_EQ(cb.try_insert(other.cbegin(), 0).error(), BufferError::out_of_range);
+
+    auto erased = cb.try_erase(cb.cbegin() + 1, cb.cbegin() + 3);
+    ASSERT_TRUE(erased.has_value());
+    ASSERT_TRUE(cb == CircularBuffer<int>({1, 4}));
+    ASSERT_FALSE(cb.try_erase(cb.cend()).has_value());
+}
+
+TEST(ITERATOR_TEST, COMPARISON_ACROSS_WRAP) {
+    CircularBuffer<int> cb(4);
+    for (int i = 0; i < 7; ++i) {
+        cb.push_back(i);
+    }
+
+    auto first = cb.cbegin();
+    auto last = cb.cend() - 1;
+    ASSERT_TRUE(first < last);
+    ASSERT_TRUE(last > first);
+    ASSERT_TRUE(first + 2 <= last - 1);
+    ASSERT_EQ(cb.cend() - cb.cbegin(), 4);
+    ASSERT_EQ(*last, 6);
+}
+
+template<typename T, typename Make>
+void CheckGapEditsAtEveryOffset(Make make) {
+    constexpr int kCapacity = 9;
+    for (int offset = 0; offset <= kCapacity; ++offset) {
+        for (int index = 0; index <= 5; ++index) {
+            for (int n: {1, 3}) {
+                CircularBuffer<T> cb(kCapacity);
+                for (int i = 0; i < offset; ++i) {
+                    cb.push_back(make(-1));
+                    cb.pop_front();
+                }
+                std::vector<T> expected;
+                for (int i = 0; i < 5; ++i) {
+                    cb.push_back(make(i));
+                    expected.push_back(make(i));
+                }
+
+                cb.insert(cb.cbegin() + index, n, make(100));
+                expected.insert(expected.begin() + index, n, make(100));
+                ASSERT_TRUE(std::equal(cb.begin(), cb.end(), expected.begin(), expected.end()));
+
+                cb.erase(cb.cbegin() + index / 2, cb.cbegin() + index / 2 + n + 1);
+                expected.erase(expected.begin() + index / 2, expected.begin() + index / 2 + n + 1);
+                ASSERT_TRUE(std::equal(cb.begin(), cb.end(), expected.begin(), expected.end()));
+            }
+        }
+    }
+}
+
+TEST(GAP_TEST, TRIVIAL_EDITS_MATCH_VECTOR_ACROSS_WRAP) {
+    CheckGapEditsAtEveryOffset<int>([](int i) { return i; });
+}
+
+TEST(GAP_TEST, NON_TRIVIAL_EDITS_MATCH_VECTOR_ACROSS_WRAP) {
+    CheckGapEditsAtEveryOffset<std::string>([](int i) { return std::string(20, static_cast<char>('a' + (i + 1) % 26)); });
+}
+
+TEST(GAP_TEST, EDITS_NEAR_FRONT_KEEP_TAIL_IN_PLACE) {
+    CircularBuffer<int> cb(8);
+    for (int i = 0; i < 6; ++i) {
+        cb.push_back(i);
+    }
+    const int* tail = &cb.back();
+
+    cb.insert(cb.cbegin() + 1, 10);
+    cb.emplace(cb.cbegin(), 11);
+    cb.erase(cb.cbegin() + 2);
+    ASSERT_EQ(tail, &cb.back());
+    ASSERT_TRUE(cb == CircularBuffer<int>({11, 0, 1, 2, 3, 4, 5}));
+}
+
+TEST(CACHE_ALIGNED_TEST, EVERY_SLOT_ON_ITS_OWN_LINE) {
+    static_assert(sizeof(CacheAligned<std::uint64_t[2]>) == 64);
+    CircularBuffer<CacheAligned<int>> cb(5);
+    for (int i = 0; i < 8; ++i) {
+        cb.push_back(i);
+    }
+
+    for (auto& slot: cb) {
+        ASSERT_EQ(reinterpret_cast<std::uintptr_t>(&slot) % 64, 0);
+    }
+    int& first = cb.front();
+    first += 10;
+    cb.back() = 42;
+    ASSERT_EQ(cb.front(), 13);
+    ASSERT_EQ(cb.back().get(), 42);
+    ASSERT_TRUE(cb == CircularBuffer<CacheAligned<int>>({13, 4, 5, 6, 42}));
+}
+
+TEST(CACHE_ALIGNED_TEST, OVER_ALIGNED_ELEMENTS_IN_PMR_RESOURCE) {
+    std::pmr::monotonic_buffer_resource arena;
+    pmr::CircularBuffer<CacheAligned<std::string, 128>> cb(3, &arena);
+    cb.push_back("a");
+    cb.emplace_back(3, 'b');
+    cb.push_front(std::string("c"));
+
+    for (const auto& slot: cb) {
+        ASSERT_EQ(reinterpret_cast<std::uintptr_t>(&slot) % 128, 0);
+    }
+    ASSERT_EQ(cb.front()->size(), 1);
+    ASSERT_EQ(cb.back().get(), "bbb");
+}
+
+TEST(PMR_TEST, SWAP_ACROSS_RESOURCES_KEEPS_CAPACITY) {
+    std::pmr::unsynchronized_pool_resource pool;
+    pmr::CircularBuffer<int> a(16, &pool);
+    pmr::CircularBuffer<int> b(4, std::pmr::new_delete_resource());
+    a.push_back(1);
+    for (int i = 0; i < 4; ++i) {
+        b.push_back(10 + i);
+    }
+
+    a.swap(b);
+    ASSERT_EQ(a.capacity(), 4);
+    ASSERT_EQ(b.capacity(), 16);
+    ASSERT_TRUE(std::equal(a.begin(), a.end(), std::vector<int>{10, 11, 12, 13}.begin()));
+    ASSERT_EQ(b.front(), 1);
+
+    for (int i = 0; i < 16; ++i) {
+        b.push_back(i);
+    }
+    ASSERT_EQ(b.size(), 16);
+    ASSERT_EQ(b.front(), 0);
+    ASSERT_EQ(b.back(), 15);
+}
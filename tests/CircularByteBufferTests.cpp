@@ -0,0 +1,120 @@
+#include "lib/CircularByteBuffer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cerrno>
+#include <memory_resource>
+#include <string>
+#include <type_traits>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+
+namespace {
+
+std::span<const std::byte> as_bytes(const std::string& s) {
+    return std::as_bytes(std::span(s.data(), s.size()));
+}
+
+std::string read_string(CircularByteBuffer<>& buffer, std::size_t n) {
+    std::string result(n, '\0');
+    result.resize(buffer.read(std::as_writable_bytes(std::span(result.data(), result.size()))));
+    return result;
+}
+
+}
+
+TEST(BYTE_BUFFER_TEST, APPEND_AND_READ_ACROSS_WRAP) {
+    CircularByteBuffer<> buffer(8);
+
+    ASSERT_EQ(buffer.append(as_bytes("abcdef")), 6);
+    ASSERT_EQ(read_string(buffer, 4), "abcd");
+    ASSERT_EQ(buffer.append(as_bytes("ghijklmn")), 6);
+    ASSERT_EQ(buffer.size(), 8);
+    ASSERT_EQ(read_string(buffer, 100), "efghijkl");
+    ASSERT_TRUE(buffer.empty());
+}
+
+TEST(BYTE_BUFFER_TEST, COPY_AND_MOVE_ASSIGNMENT) {
+    CircularByteBuffer<> source(8);
+    source.append(as_bytes("abcdef"));
+    read_string(source, 4);
+    source.append(as_bytes("ghij"));
+
+    CircularByteBuffer<> copy(2);
+    copy = source;
+    ASSERT_EQ(read_string(copy, 8), "efghij");
+    ASSERT_EQ(source.size(), 6);
+
+    CircularByteBuffer<> moved(2);
+    moved = std::move(source);
+    ASSERT_EQ(moved.capacity(), 8);
+    ASSERT_EQ(read_string(moved, 8), "efghij");
+}
+
+TEST(BYTE_BUFFER_TEST, MOVED_FROM_POOL_BUFFER_DESTROYS_CLEANLY) {
+    using PmrByteBuffer = CircularByteBuffer<std::pmr::polymorphic_allocator<std::byte>>;
+    static_assert(!std::is_nothrow_move_assignable_v<PmrByteBuffer>);
+    static_assert(std::is_nothrow_move_assignable_v<CircularByteBuffer<>>);
+
+    std::pmr::synchronized_pool_resource pool;
+    PmrByteBuffer source(8, &pool);
+    source.append(as_bytes("abc"));
+    {
+        PmrByteBuffer moved(std::move(source));
+        ASSERT_EQ(moved.size(), 3);
+    }
+}
+
+TEST(BYTE_BUFFER_TEST, PIPE_READ_FROM_AND_WRITE_TO) {
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+    CircularByteBuffer<> buffer(8);
+    buffer.append(as_bytes("xxxxxx"));
+    read_string(buffer, 6);
+
+    ASSERT_EQ(::write(fds[1], "0123456789", 10), 10);
+    ASSERT_EQ(buffer.read_from(fds[0]), 8);
+    errno = 0;
+    ASSERT_EQ(buffer.read_from(fds[0]), -1);
+    ASSERT_EQ(errno, ENOBUFS);
+
+    ASSERT_EQ(buffer.write_to(fds[1]), 8);
+    ASSERT_TRUE(buffer.empty());
+    errno = 0;
+    ASSERT_EQ(buffer.write_to(fds[1]), -1);
+    ASSERT_EQ(errno, ENODATA);
+
+    ASSERT_EQ(buffer.read_from(fds[0]), 8);
+    ASSERT_EQ(read_string(buffer, 8), "89012345");
+
+    ::close(fds[1]);
+    ASSERT_EQ(buffer.read_from(fds[0]), 2);
+    ASSERT_EQ(read_string(buffer, 8), "67");
+    ASSERT_EQ(buffer.read_from(fds[0]), 0);
+    ::close(fds[0]);
+}
+
+TEST(BYTE_BUFFER_TEST, SOCKETPAIR_ROUND_TRIP) {
+    int fds[2];
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    CircularByteBuffer<> out(16);
+    CircularByteBuffer<> in(16);
+
+    out.append(as_bytes("hello, "));
+    ASSERT_EQ(out.write_to(fds[0]), 7);
+    out.append(as_bytes("socket world"));
+    ASSERT_EQ(out.write_to(fds[0]), 12);
+
+    std::string received;
+    while (received.size() < 19) {
+        ASSERT_GT(in.read_from(fds[1]), 0);
+        received += read_string(in, 16);
+    }
+    ASSERT_EQ(received, "hello, socket world");
+
+    ::close(fds[0]);
+    ASSERT_EQ(in.read_from(fds[1]), 0);
+    ::close(fds[1]);
+}
@@ -0,0 +1,87 @@
+#include "lib/CompressedSeriesBuffer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+
+namespace {
+
+std::vector<std::int64_t> decode_all(const CompressedSeriesBuffer<>& series) {
+    std::vector<std::int64_t> out;
+    series.for_each([&out](std::int64_t value) { out.push_back(value); });
+    return out;
+}
+
+} // namespace
+
+TEST(COMPRESSED_SERIES_TEST, ROUND_TRIPS_EVERY_DELTA_WIDTH) {
+    std::mt19937_64 rng(7);
+    std::vector<std::int64_t> expected;
+    CompressedSeriesBuffer<> series(1 << 20);
+    for (unsigned width = 0; width <= 64; ++width) {
+        const std::uint64_t mask = (width == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << width) - 1);
+        for (std::size_t i = 0; i < CompressedSeriesBuffer<>::kBlockSize; ++i) {
+            // Wraps modulo 2^64 like the encoder's deltas; signed addition would overflow.
+            const std::uint64_t previous = expected.empty() ? 0 : static_cast<std::uint64_t>(expected.back());
+            const auto value = static_cast<std::int64_t>(previous + (rng() & mask));
+            expected.push_back(value);
+            series.push_back(value);
+        }
+    }
+    for (std::int64_t value: {std::numeric_limits<std::int64_t>::min(), std::numeric_limits<std::int64_t>::max(),
+                              std::int64_t{-1}, std::int64_t{5}}) {
+        expected.push_back(value);
+        series.push_back(value);
+    }
+
+    ASSERT_EQ(series.size(), expected.size());
+    ASSERT_EQ(decode_all(series), expected);
+    std::vector<std::int64_t> copied(series.size());
+    series.copy_to(copied.data());
+    ASSERT_EQ(copied, expected);
+    ASSERT_EQ(series.front(), 0);
+    ASSERT_EQ(series.back(), 5);
+}
+
+TEST(COMPRESSED_SERIES_TEST, EVICTS_WHOLE_BLOCKS_FROM_THE_FRONT) {
+    constexpr std::size_t kBlock = CompressedSeriesBuffer<>::kBlockSize;
+    CompressedSeriesBuffer<> series(4096);
+    std::int64_t timestamp = 1'700'000'000'000'000'000;
+    std::vector<std::int64_t> pushed;
+    for (std::size_t i = 0; i < 200 * kBlock + 5; ++i) {
+        timestamp += 1000 + static_cast<std::int64_t>(i % 37);
+        pushed.push_back(timestamp);
+        series.push_back(timestamp);
+    }
+
+    ASSERT_GT(series.evicted(), 0);
+    ASSERT_EQ(series.evicted() % kBlock, 0);
+    ASSERT_EQ(series.evicted() + series.size(), pushed.size());
+    ASSERT_LE(series.compressed_bytes(), series.capacity_bytes());
+    ASSERT_EQ(decode_all(series), std::vector<std::int64_t>(pushed.begin() + series.evicted(), pushed.end()));
+    ASSERT_EQ(series.front(), pushed[series.evicted()]);
+
+    // 11-bit deltas: a block takes 128 * 8 raw bytes and about 200 compressed ones.
+    ASSERT_GE((series.size() - 5) * sizeof(std::int64_t), 4 * series.compressed_bytes());
+}
+
+TEST(COMPRESSED_SERIES_TEST, EMPTY_AND_TOO_SMALL) {
+    ASSERT_THROW(CompressedSeriesBuffer<>(512), std::length_error);
+    CompressedSeriesBuffer<> series(CompressedSeriesBuffer<>::max_block_bytes() + 8);
+    ASSERT_TRUE(series.empty());
+    ASSERT_THROW(series.front(), std::out_of_range);
+
+    for (std::int64_t i = 0; i < 300; ++i) {
+        series.push_back(i * i * 1'000'003);
+    }
+    ASSERT_EQ(series.size(), 300 - series.evicted());
+    ASSERT_EQ(series.back(), std::int64_t{299} * 299 * 1'000'003);
+    series.clear();
+    ASSERT_TRUE(series.empty());
+    ASSERT_EQ(series.evicted(), 0);
+}
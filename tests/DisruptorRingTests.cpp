@@ -0,0 +1,105 @@
+#include "lib/DisruptorRing.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+
+
+namespace {
+
+struct Event {
+    std::uint64_t value;
+    // Set by the journal consumer; the business consumer must never see it unset.
+    bool journaled;
+};
+
+// Producer publishes in batches; the journal marks every event, the replicator sums independently, and the
+// business consumer runs after the journal.
+template<typename Wait>
+void run_pipeline(std::uint64_t events) {
+    DisruptorRing<Event, Wait> ring(256);
+    const auto journal = ring.add_consumer();
+    const auto replicator = ring.add_consumer();
+    const auto business = ring.add_consumer(std::uint64_t{1} << journal);
+
+    std::uint64_t replicated = 0;
+    std::uint64_t business_sum = 0;
+    std::uint64_t unjournaled = 0;
+    auto consume = [&ring, events](auto consumer, auto&& handle) {
+        for (std::uint64_t next = 0; next < events;) {
+            const auto end = ring.wait_for(consumer, next);
+            for (; next < end; ++next) {
+                handle(ring[next]);
+            }
+            ring.release(consumer, end);
+        }
+    };
+    std::thread threads[] = {
+            std::thread([&] { consume(journal, [](Event& event) { event.journaled = true; }); }),
+            std::thread([&] { consume(replicator, [&](const Event& event) { replicated += event.value; }); }),
+            std::thread([&] {
+                consume(business, [&](const Event& event) {
+                    business_sum += event.value;
+                    unjournaled += !event.journaled;
+                });
+            }),
+    };
+
+    for (std::uint64_t next = 0; next < events;) {
+        const auto batch = std::min<std::uint64_t>(1 + next % 13, events - next);
+        const auto first = ring.claim(batch);
+        ASSERT_EQ(first, next);
+        for (std::uint64_t i = 0; i < batch; ++i) {
+            ring[first + i] = Event{first + i, false};
+        }
+        next += batch;
+        ring.publish(next);
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+
+    const std::uint64_t expected = events * (events - 1) / 2;
+    ASSERT_EQ(replicated, expected);
+    ASSERT_EQ(business_sum, expected);
+    ASSERT_EQ(unjournaled, 0);
+}
+
+} // namespace
+
+TEST(DISRUPTOR_RING_TEST, PRODUCER_IS_GATED_BY_THE_SLOWEST_CONSUMER) {
+    DisruptorRing<int> ring(3);
+    ASSERT_EQ(ring.capacity(), 4);
+    const auto fast = ring.add_consumer();
+    const auto slow = ring.add_consumer();
+    const auto after_both = ring.add_consumer(0b11);
+    ASSERT_THROW(ring.add_consumer(std::uint64_t{1} << 5), std::out_of_range);
+
+    const auto first = *ring.try_claim(3);
+    for (int i = 0; i < 3; ++i) {
+        ring[first + i] = i + 1;
+    }
+    ring.publish(first + 3);
+    ASSERT_FALSE(ring.try_claim(2).has_value());
+
+    int sum = 0;
+    ASSERT_EQ(ring.poll(fast, [&sum](int value, auto) { sum += value; }), 3);
+    ASSERT_EQ(sum, 6);
+    ASSERT_EQ(ring.available(after_both), 0);
+    ASSERT_FALSE(ring.try_claim(2).has_value());
+
+    ASSERT_EQ(ring.available(slow), 3);
+    ring.release(slow, 1);
+    ASSERT_EQ(ring.available(after_both), 1);
+    ASSERT_EQ(ring.poll(after_both, [](int value, auto sequence) { ASSERT_EQ(value, 1); ASSERT_EQ(sequence, 0); }), 1);
+    ASSERT_EQ(*ring.try_claim(2), 3);
+    ASSERT_EQ(ring.poll(fast, [](int, auto) {}), 0);
+}
+
+TEST(DISRUPTOR_RING_TEST, DEPENDENT_CONSUMERS_WITH_EVERY_WAIT_STRATEGY) {
+    run_pipeline<BlockingWait>(100'000);
+    run_pipeline<YieldingWait>(100'000);
+    run_pipeline<BusySpinWait>(2'000);
+}
@@ -0,0 +1,44 @@
+#include "lib/CircularBuffer.hpp"
+#include "lib/CircularBufferExt.hpp"
+#include "lib/HugePageAllocator.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+
+TEST(HUGE_PAGE_ALLOCATOR_TEST, SMALL_BUFFER_FALLS_BACK_TO_REGULAR_PAGES) {
+    CircularBuffer<int, HugePageAllocator<int>> cb(4, HugePageAllocator<int>());
+    for (int i = 0; i < 6; ++i) {
+        cb.push_back(i);
+    }
+
+    ASSERT_TRUE(cb == (CircularBuffer<int, HugePageAllocator<int>>({2, 3, 4, 5})));
+}
+
+TEST(HUGE_PAGE_ALLOCATOR_TEST, LARGE_BUFFER_IS_HUGE_PAGE_ALIGNED) {
+    using Alloc = HugePageAllocator<std::uint64_t>;
+    const std::size_t capacity = Alloc::kHugePageSize / sizeof(std::uint64_t) * 2;
+    CircularBuffer<std::uint64_t, Alloc> cb(capacity, Alloc({.huge_pages = true, .populate = true}));
+    for (std::size_t i = 0; i < capacity + 10; ++i) {
+        cb.push_back(i);
+    }
+
+    ASSERT_EQ(cb.size(), capacity);
+    ASSERT_EQ(cb.front(), 10);
+    ASSERT_EQ(cb.back(), capacity + 9);
+    const auto regions = cb.peek(cb.size());
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(regions.second.data()) % Alloc::kHugePageSize, 0);
+}
+
+TEST(HUGE_PAGE_ALLOCATOR_TEST, NUMA_BINDING_IS_BEST_EFFORT) {
+    using Alloc = HugePageAllocator<int>;
+    CircularBufferExt<int, 2, Alloc> cb(Alloc({.huge_pages = false, .populate = true, .numa_node = 0}));
+    for (int i = 0; i < 100000; ++i) {
+        cb.push_back(i);
+    }
+
+    ASSERT_EQ(cb.size(), 100000);
+    ASSERT_EQ(cb.back(), 99999);
+    ASSERT_EQ(cb.get_allocator().options().numa_node, 0);
+}
@@ -0,0 +1,78 @@
+#include "lib/CircularBuffer.hpp"
+#include "lib/CircularBufferExt.hpp"
+#include "lib/LatencyHistogram.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <thread>
+
+
+TEST(LATENCY_HISTOGRAM_TEST, BUCKETS_ARE_CONTIGUOUS) {
+    for (std::size_t bucket = 1; bucket < LatencyHistogram::kBucketCount; ++bucket) {
+        ASSERT_EQ(LatencyHistogram::lowest_in_bucket(bucket), LatencyHistogram::highest_in_bucket(bucket - 1) + 1);
+        ASSERT_EQ(LatencyHistogram::bucket_of(LatencyHistogram::lowest_in_bucket(bucket)), bucket);
+    }
+    ASSERT_EQ(LatencyHistogram::bucket_of(~std::uint64_t{0}), LatencyHistogram::kBucketCount - 1);
+}
+
+TEST(LATENCY_HISTOGRAM_TEST, PERCENTILES_WITHIN_RELATIVE_ERROR) {
+    LatencyHistogram histogram;
+    for (std::uint64_t v = 1; v <= 100000; ++v) {
+        histogram.record(v);
+    }
+
+    ASSERT_EQ(histogram.count(), 100000);
+    ASSERT_EQ(histogram.max(), 100000);
+    ASSERT_NEAR(histogram.percentile(0.5), 50000, 50000 * 0.07);
+    ASSERT_NEAR(histogram.percentile(0.99), 99000, 99000 * 0.07);
+    ASSERT_LE(histogram.percentile(1.0), 100000);
+}
+
+TEST(LATENCY_HISTOGRAM_TEST, MERGE_PER_THREAD_HISTOGRAMS) {
+    LatencyHistogram per_thread[4];
+    std::thread threads[4];
+    for (int t = 0; t < 4; ++t) {
+        threads[t] = std::thread([&histogram = per_thread[t], t] {
+            for (int i = 0; i < 1000; ++i) {
+                histogram.record(t * 1000 + i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    LatencyHistogram total;
+    for (const auto& histogram : per_thread) {
+        total.merge(histogram);
+    }
+    ASSERT_EQ(total.count(), 4000);
+    ASSERT_EQ(total.max(), 3999);
+}
+
+TEST(LATENCY_TRACER_TEST, RECORDS_BUFFER_OPERATIONS) {
+    CircularBufferExt<int, 2, std::allocator<int>, LatencyTracer<BufferStats>> cb;
+    for (int i = 0; i < 100; ++i) {
+        cb.push_back(i);
+    }
+    cb.insert(cb.cbegin() + 10, 5);
+    cb.erase(cb.cbegin() + 3);
+    while (!cb.empty()) {
+        cb.pop_front();
+    }
+
+    const auto& tracer = cb.stats();
+    ASSERT_EQ(tracer.histogram(BufferOperation::push_back).count(), 100);
+    ASSERT_EQ(tracer.histogram(BufferOperation::pop_front).count(), 100);
+    ASSERT_EQ(tracer.histogram(BufferOperation::insert).count(), 1);
+    ASSERT_EQ(tracer.histogram(BufferOperation::erase).count(), 1);
+    ASSERT_EQ(tracer.histogram(BufferOperation::reserve).count(), tracer.growths());
+    ASSERT_EQ(tracer.pushes(), 101);
+    ASSERT_EQ(tracer.pops(), 101);
+
+    std::ostringstream out;
+    tracer.report(out);
+    ASSERT_NE(out.str().find("push_back count=100 p50="), std::string::npos);
+    ASSERT_EQ(out.str().find("push_front"), std::string::npos);
+}
@@ -0,0 +1,119 @@
+#include "lib/MappedCircularBuffer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <filesystem>
+
+
+namespace {
+
+struct Record {
+    std::uint64_t id;
+    double value;
+};
+
+std::filesystem::path temp_ring_path(const std::string& name) {
+    auto path = std::filesystem::temp_directory_path() / ("mapped_ring_" + std::to_string(::getpid()) + "_" + name);
+    std::filesystem::remove(path);
+    return path;
+}
+
+}
+
+TEST(MAPPED_BUFFER_TEST, REOPEN_RECOVERS_CONTENTS) {
+    auto path = temp_ring_path("reopen");
+    {
+        MappedCircularBuffer<Record> ring(path, 4);
+        for (std::uint64_t i = 0; i < 6; ++i) {
+            ring.push_back({i, i * 0.5});
+        }
+        ring.pop_front();
+        ring.flush();
+    }
+
+    MappedCircularBuffer<Record> ring(path, 4);
+    ASSERT_EQ(ring.size(), 3);
+    ASSERT_EQ(ring.sequence(), 7);
+    ASSERT_EQ(ring.front().id, 3);
+    ASSERT_EQ(ring.back().id, 5);
+    ASSERT_DOUBLE_EQ(ring[1].value, 2.0);
+
+    auto regions = ring.peek(3);
+    ASSERT_EQ(regions.size(), 3);
+    ASSERT_EQ(regions.first.front().id, 3);
+
+    std::filesystem::remove(path);
+}
+
+TEST(MAPPED_BUFFER_TEST, REOPEN_AFTER_WRAP_AND_UNPUBLISHED_PUSH) {
+    auto path = temp_ring_path("wrapped");
+    {
+        MappedCircularBuffer<std::uint64_t> ring(path, 4);
+        for (std::uint64_t i = 0; i < 10; ++i) {
+            ring.push_back(i);
+        }
+    }
+    {
+        MappedCircularBuffer<std::uint64_t> ring(path, 4);
+        ASSERT_EQ(ring.size(), 4);
+        for (std::uint64_t i = 0; i < 4; ++i) {
+            ASSERT_EQ(ring[i], 6 + i);
+        }
+    }
+    {
+        // A push that crashed before publishing: its value lands in the spare slot, here slot 0 of 5
+        // (head 1 after ten pushes), and the header still describes the previous state.
+        int fd = ::open(path.c_str(), O_RDWR);
+        const std::uint64_t torn = 100;
+        ASSERT_EQ(::pwrite(fd, &torn, sizeof(torn), sizeof(MappedRingHeader)), sizeof(torn));
+        ::close(fd);
+    }
+
+    MappedCircularBuffer<std::uint64_t> ring(path, 4);
+    ASSERT_EQ(ring.sequence(), 10);
+    ASSERT_EQ(ring.front(), 6);
+    ASSERT_EQ(ring.back(), 9);
+    ring.push_back(10);
+    ASSERT_EQ(ring.front(), 7);
+    ASSERT_EQ(ring.back(), 10);
+
+    std::filesystem::remove(path);
+}
+
+TEST(MAPPED_BUFFER_TEST, TORN_HEADER_FALLS_BACK_TO_PREVIOUS_STATE) {
+    auto path = temp_ring_path("torn");
+    {
+        MappedCircularBuffer<int> ring(path, 8);
+        ring.push_back(1);
+        ring.push_back(2);
+        ring.push_back(3);
+    }
+    {
+        // The third push wrote its state to slot 1: scribble over its checksum.
+        int fd = ::open(path.c_str(), O_RDWR);
+        const std::uint64_t garbage = 42;
+        const auto offset = offsetof(MappedRingHeader, states) + sizeof(MappedRingState) +
+                            offsetof(MappedRingState, checksum);
+        ASSERT_EQ(::pwrite(fd, &garbage, sizeof(garbage), offset), sizeof(garbage));
+        ::close(fd);
+    }
+
+    MappedCircularBuffer<int> ring(path, 8);
+    ASSERT_EQ(ring.sequence(), 2);
+    ASSERT_EQ(ring.size(), 2);
+    ASSERT_EQ(ring.back(), 2);
+
+    std::filesystem::remove(path);
+}
+
+TEST(MAPPED_BUFFER_TEST, CAPACITY_MISMATCH) {
+    auto path = temp_ring_path("mismatch");
+    {
+        MappedCircularBuffer<int> ring(path, 8);
+    }
+
+    ASSERT_THROW(MappedCircularBuffer<int>(path, 16), std::invalid_argument);
+
+    std::filesystem::remove(path);
+}
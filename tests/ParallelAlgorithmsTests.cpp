@@ -0,0 +1,89 @@
+#include "lib/CircularBuffer.hpp"
+#include "lib/CircularBufferExt.hpp"
+#include "lib/ParallelAlgorithms.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+
+namespace {
+
+// Wrapped buffer holding `n` pseudo-random values.
+CircularBuffer<std::int64_t> make_wrapped(std::size_t n) {
+    CircularBuffer<std::int64_t> cb(n);
+    std::uint64_t state = 88172645463325252ULL;
+    for (std::size_t i = 0; i < n + n / 3; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        cb.push_back(static_cast<std::int64_t>(state % 1000003));
+    }
+    return cb;
+}
+
+} // namespace
+
+TEST(PARALLEL_TEST, FOR_EACH_AND_REDUCE_MATCH_SERIAL) {
+    ThreadPool pool(4);
+    auto cb = make_wrapped(200000);
+    ASSERT_FALSE(cb.peek(cb.size()).second.empty());
+
+    const auto serial = parallel::reduce(parallel::seq, cb, std::int64_t{0});
+    ASSERT_EQ(parallel::reduce(pool, cb, std::int64_t{0}), serial);
+
+    parallel::for_each(pool, cb, [](std::int64_t& value) { value *= 2; });
+    ASSERT_EQ(parallel::reduce(parallel::par, cb, std::int64_t{0}), 2 * serial);
+    ASSERT_EQ(parallel::reduce(pool, cb, std::int64_t{5}, [](auto a, auto b) { return std::max(a, b); }),
+              *std::max_element(cb.begin(), cb.end()));
+}
+
+TEST(PARALLEL_TEST, TRANSFORM_BETWEEN_DIFFERENTLY_WRAPPED_BUFFERS) {
+    ThreadPool pool(3);
+    const auto src = make_wrapped(100000);
+    CircularBufferExt<std::int64_t> dst;
+    for (std::size_t i = 0; i < src.size(); ++i) {
+        dst.push_front(0);
+    }
+
+    parallel::transform(pool, src, dst, [](std::int64_t value) { return value + 1; });
+    ASSERT_TRUE(std::equal(src.begin(), src.end(), dst.begin(), dst.end(),
+                           [](std::int64_t a, std::int64_t b) { return a + 1 == b; }));
+
+    CircularBufferExt<std::int64_t> small;
+    ASSERT_THROW(parallel::transform(pool, src, small, [](std::int64_t value) { return value; }), std::out_of_range);
+}
+
+TEST(PARALLEL_TEST, SORT_ACROSS_WRAP) {
+    for (std::size_t threads: {1, 2, 5}) {
+        ThreadPool pool(threads);
+        auto cb = make_wrapped(150001);
+        auto expected = make_wrapped(150001);
+        std::sort(expected.begin(), expected.end());
+
+        parallel::sort(pool, cb);
+        ASSERT_TRUE(cb == expected);
+    }
+
+    CircularBuffer<std::string> words(4);
+    for (const char* word: {"pear", "fig", "apple", "kiwi", "date"}) {
+        words.push_back(word);
+    }
+    parallel::sort(parallel::par, words, std::greater<>());
+    ASSERT_TRUE(words == CircularBuffer<std::string>({"kiwi", "fig", "date", "apple"}));
+}
+
+TEST(PARALLEL_TEST, POOL_RETHROWS_TASK_EXCEPTIONS) {
+    ThreadPool pool(4);
+    std::atomic<int> ran{0};
+    ASSERT_THROW(pool.run(64, [&](std::size_t i) {
+        ran.fetch_add(1);
+        if (i == 17) {
+            throw std::runtime_error("task failed");
+        }
+    }), std::runtime_error);
+    ASSERT_EQ(ran.load(), 64);
+}
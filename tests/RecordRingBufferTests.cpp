@@ -0,0 +1,92 @@
+#include "lib/RecordRingBuffer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+
+namespace {
+
+bool push_string(RecordRingBuffer<>& ring, const std::string& s) {
+    auto payload = ring.reserve(s.size());
+    if (payload.size() != s.size()) {
+        return false;
+    }
+    std::memcpy(payload.data(), s.data(), s.size());
+    ring.commit(s.size());
+    return true;
+}
+
+std::string front_string(const RecordRingBuffer<>& ring) {
+    auto record = ring.front_record();
+    return {reinterpret_cast<const char*>(record.data()), record.size()};
+}
+
+}
+
+TEST(RECORD_RING_TEST, FIFO_ORDER) {
+    RecordRingBuffer<> ring(256);
+    ASSERT_TRUE(push_string(ring, "first"));
+    ASSERT_TRUE(push_string(ring, ""));
+    ASSERT_TRUE(push_string(ring, "third record"));
+
+    ASSERT_EQ(ring.records(), 3);
+    ASSERT_EQ(front_string(ring), "first");
+    ring.pop_record();
+    ASSERT_EQ(front_string(ring), "");
+    ring.pop_record();
+    ASSERT_EQ(front_string(ring), "third record");
+    ring.pop_record();
+    ASSERT_TRUE(ring.empty());
+    ASSERT_THROW(ring.pop_record(), std::out_of_range);
+}
+
+TEST(RECORD_RING_TEST, RECORDS_ARE_NOT_SPLIT_ACROSS_WRAP) {
+    RecordRingBuffer<> ring(64);
+    const std::string a(24, 'a');
+    const std::string b(8, 'b');
+    const std::string c(20, 'c');
+
+    ASSERT_TRUE(push_string(ring, a));
+    ASSERT_TRUE(push_string(ring, b));
+    ASSERT_FALSE(push_string(ring, c));
+    ring.pop_record();
+    // 16 bytes are left at the tail, so c goes to the front in one piece.
+    ASSERT_TRUE(push_string(ring, c));
+    ASSERT_FALSE(push_string(ring, "d"));
+
+    ASSERT_EQ(front_string(ring), b);
+    ring.pop_record();
+    ASSERT_EQ(front_string(ring), c);
+    ring.pop_record();
+    ASSERT_TRUE(ring.empty());
+    ASSERT_TRUE(push_string(ring, std::string(56, 'e')));
+}
+
+TEST(RECORD_RING_TEST, COMMIT_SHORTER_THAN_RESERVED) {
+    RecordRingBuffer<> ring(128);
+    auto payload = ring.reserve(64);
+    ASSERT_EQ(payload.size(), 64);
+    std::memcpy(payload.data(), "abc", 3);
+    ring.commit(3);
+
+    ASSERT_EQ(front_string(ring), "abc");
+    ASSERT_EQ(ring.bytes_used(), RecordRingBuffer<>::record_footprint(3));
+    ASSERT_THROW(ring.commit(1), std::logic_error);
+}
+
+TEST(RECORD_RING_TEST, FOR_EACH_RECORD_WALKS_BOTH_REGIONS) {
+    RecordRingBuffer<> ring(64);
+    ASSERT_TRUE(push_string(ring, std::string(24, 'a')));
+    ASSERT_TRUE(push_string(ring, "bb"));
+    ring.pop_record();
+    // 16 bytes are left at the tail, so the third record starts region B.
+    ASSERT_TRUE(push_string(ring, std::string(12, 'c')));
+
+    std::string joined;
+    ring.for_each_record([&joined](std::span<const std::byte> record) {
+        joined.append(reinterpret_cast<const char*>(record.data()), record.size());
+        joined += '|';
+    });
+    ASSERT_EQ(joined, "bb|cccccccccccc|");
+}
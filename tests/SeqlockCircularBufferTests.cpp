@@ -0,0 +1,104 @@
+#include "lib/SeqlockCircularBuffer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+
+namespace {
+
+// Every field is derived from the sequence number, so a torn copy is detectable.
+struct Quote {
+    std::uint64_t sequence;
+    std::uint64_t bid;
+    std::uint64_t ask;
+    std::uint64_t check;
+
+    static Quote make(std::uint64_t sequence) noexcept {
+        return Quote{sequence, sequence * 3, sequence * 3 + 1, ~sequence};
+    }
+
+    bool consistent() const noexcept {
+        return bid == sequence * 3 && ask == sequence * 3 + 1 && check == ~sequence;
+    }
+};
+
+} // namespace
+
+TEST(SEQLOCK_BUFFER_TEST, KEEPS_THE_NEWEST_ENTRIES) {
+    SeqlockCircularBuffer<int> ring(4);
+    std::array<int, 8> out{};
+    ASSERT_EQ(ring.snapshot(out.data(), out.size()), 0);
+
+    for (int i = 1; i <= 6; ++i) {
+        ring.push_back(i);
+    }
+    ASSERT_EQ(ring.size(), 4);
+    ASSERT_EQ(ring.pushed(), 6);
+    ASSERT_EQ(ring.snapshot(out.data(), 3), 3);
+    ASSERT_EQ(out[0], 4);
+    ASSERT_EQ(out[2], 6);
+
+    const std::array<int, 6> batch{10, 11, 12, 13, 14, 15};
+    ring.push_back(std::span<const int>(batch));
+    auto last = ring.last(8);
+    ASSERT_EQ(last.size(), 4);
+    ASSERT_EQ(last.front(), 12);
+    ASSERT_EQ(last.back(), 15);
+
+    ring.clear();
+    ASSERT_EQ(ring.snapshot(out.data(), out.size()), 0);
+    SeqlockCircularBuffer<int> empty;
+    empty.push_back(1);
+    ASSERT_EQ(empty.last(2).size(), 0);
+}
+
+TEST(SEQLOCK_BUFFER_TEST, READERS_NEVER_SEE_TORN_OR_REORDERED_ENTRIES) {
+    constexpr std::uint64_t kPushes = 200'000;
+    constexpr std::size_t kWindow = 16;
+    SeqlockCircularBuffer<Quote> ring(64);
+    std::atomic<bool> done{false};
+    std::atomic<std::uint64_t> failures{0};
+
+    auto reader = [&] {
+        std::array<Quote, kWindow> out;
+        std::uint64_t newest = 0;
+        while (!done.load(std::memory_order_acquire)) {
+            const std::size_t n = ring.snapshot(out.data(), kWindow);
+            for (std::size_t i = 0; i < n; ++i) {
+                if (!out[i].consistent() || (i != 0 && out[i].sequence != out[i - 1].sequence + 1)) {
+                    failures.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            if (n != 0) {
+                failures.fetch_add(out[n - 1].sequence < newest, std::memory_order_relaxed);
+                newest = out[n - 1].sequence;
+            }
+        }
+    };
+    std::thread readers[3] = {std::thread(reader), std::thread(reader), std::thread(reader)};
+
+    std::array<Quote, 5> batch;
+    for (std::uint64_t i = 1; i <= kPushes;) {
+        if (i % 7 == 0 && i + batch.size() <= kPushes) {
+            for (auto& quote: batch) {
+                quote = Quote::make(i++);
+            }
+            ring.push_back(std::span<const Quote>(batch));
+        } else {
+            ring.push_back(Quote::make(i++));
+        }
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& thread: readers) {
+        thread.join();
+    }
+
+    ASSERT_EQ(failures.load(), 0);
+    const auto last = ring.last(kWindow);
+    ASSERT_EQ(last.back().sequence, kPushes);
+    ASSERT_EQ(last.front().sequence, kPushes - kWindow + 1);
+}
@@ -0,0 +1,112 @@
+#include "lib/ShardedRecorder.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+
+namespace {
+
+struct Event {
+    int thread;
+    int index;
+};
+
+struct ManualClock {
+    using duration = std::chrono::nanoseconds;
+    using time_point = std::chrono::time_point<ManualClock>;
+
+    static inline std::int64_t ticks = 0;
+
+    static time_point now() noexcept {
+        return time_point(duration(ticks));
+    }
+};
+
+} // namespace
+
+TEST(SHARDED_RECORDER_TEST, MERGES_SHARDS_BY_TIMESTAMP) {
+    ShardedRecorder<int, ManualClock> recorder(4, 3);
+    auto a = recorder.writer();
+    auto b = recorder.writer();
+
+    ManualClock::ticks = 10;
+    b.record(1);
+    ManualClock::ticks = 20;
+    a.record(2);
+    a.record(3);
+    ManualClock::ticks = 30;
+    b.record(4);
+
+    const auto all = recorder.collect();
+    ASSERT_EQ(all.size(), 4);
+    int expected = 1;
+    for (const auto& entry: all) {
+        ASSERT_EQ(entry.value, expected++);
+    }
+    ASSERT_EQ(all.front().shard, 1);
+    ASSERT_EQ(all.back().timestamp, 30);
+
+    const auto recent = recorder.last(2);
+    ASSERT_EQ(recent.size(), 2);
+    ASSERT_EQ(recent.front().value, 3);
+    ASSERT_EQ(recent.back().value, 4);
+}
+
+TEST(SHARDED_RECORDER_TEST, SHARDS_KEEP_ONLY_THEIR_CAPACITY) {
+    ShardedRecorder<int, ManualClock> recorder(3, 1);
+    auto writer = recorder.writer();
+    for (int i = 0; i < 10; ++i) {
+        ManualClock::ticks = i;
+        writer.record(i);
+    }
+
+    const auto all = recorder.collect();
+    ASSERT_EQ(all.size(), 3);
+    ASSERT_EQ(all.front().value, 7);
+    ASSERT_EQ(all.front().sequence, 7);
+    ASSERT_THROW(recorder.writer(), std::length_error);
+}
+
+TEST(SHARDED_RECORDER_TEST, CONCURRENT_WRITERS_AND_READER) {
+    constexpr int kThreads = 4;
+    constexpr int kEvents = 20000;
+    ShardedRecorder<Event> recorder(1024, kThreads);
+    std::atomic<int> done{0};
+
+    std::thread reader([&] {
+        while (done.load() != kThreads) {
+            const auto snapshot = recorder.collect();
+            for (auto it = snapshot.begin(); it != snapshot.end() && it + 1 != snapshot.end(); ++it) {
+                ASSERT_LE(it->timestamp, (it + 1)->timestamp);
+            }
+            ASSERT_LE(recorder.last(100).size(), 100);
+        }
+    });
+    std::thread writers[kThreads];
+    for (int t = 0; t < kThreads; ++t) {
+        writers[t] = std::thread([&recorder, &done, t] {
+            auto writer = recorder.writer();
+            for (int i = 0; i < kEvents; ++i) {
+                writer.record(Event{t, i});
+            }
+            done.fetch_add(1);
+        });
+    }
+    for (auto& writer: writers) {
+        writer.join();
+    }
+    reader.join();
+
+    const auto all = recorder.collect();
+    ASSERT_EQ(all.size(), kThreads * 1024);
+    int last_index[kThreads] = {};
+    for (const auto& entry: all) {
+        ASSERT_GE(entry.value.index, last_index[entry.value.thread]);
+        last_index[entry.value.thread] = entry.value.index;
+    }
+    for (int index: last_index) {
+        ASSERT_EQ(index, kEvents - 1);
+    }
+}
@@ -0,0 +1,59 @@
+#include "lib/CircularBuffer.hpp"
+#include "lib/CircularBufferExt.hpp"
+#include "lib/SortedSearch.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+
+
+namespace {
+
+struct Record {
+    std::int64_t time;
+    int payload;
+};
+
+} // namespace
+
+TEST(SORTED_SEARCH_TEST, MATCHES_STD_AT_EVERY_WRAP_OFFSET) {
+    for (int offset = 0; offset < 8; ++offset) {
+        CircularBuffer<int> cb(7);
+        for (int i = 0; i < offset; ++i) {
+            cb.push_back(-100);
+        }
+        for (int value: {1, 3, 3, 3, 5, 8, 8}) {
+            cb.push_back(value);
+        }
+
+        for (int key = 0; key <= 9; ++key) {
+            ASSERT_EQ(sorted::lower_bound(cb, key), std::lower_bound(cb.begin(), cb.end(), key));
+            ASSERT_EQ(sorted::upper_bound(cb, key), std::upper_bound(cb.begin(), cb.end(), key));
+            const auto [first, last] = sorted::equal_range(cb, key);
+            ASSERT_EQ(last - first, std::count(cb.begin(), cb.end(), key));
+        }
+    }
+}
+
+TEST(SORTED_SEARCH_TEST, PROJECTION_AND_PREFIX_ERASE) {
+    CircularBufferExt<Record> window;
+    for (int i = 0; i < 20; ++i) {
+        window.push_back(Record{i * 10, i});
+    }
+    for (int i = 0; i < 5; ++i) {
+        window.pop_front();
+        window.push_back(Record{200 + i * 10, 20 + i});
+    }
+
+    ASSERT_EQ(sorted::lower_bound(window, 105, &Record::time)->payload, 11);
+    ASSERT_EQ(sorted::upper_bound(window, 110, &Record::time)->payload, 12);
+    ASSERT_EQ(sorted::lower_bound(window, 1000, &Record::time), window.end());
+
+    ASSERT_EQ(sorted::erase_before(window, 120, &Record::time), 7);
+    ASSERT_EQ(window.front().time, 120);
+    ASSERT_EQ(sorted::erase_after(window, 215, &Record::time), 3);
+    ASSERT_EQ(window.back().time, 210);
+    ASSERT_EQ(sorted::erase_before(window, 0, &Record::time), 0);
+    ASSERT_EQ(window.size(), 10);
+}
@@ -0,0 +1,76 @@
+#include "lib/SortedSearch.hpp"
+#include "lib/TimeWindowBuffer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+
+
+namespace {
+
+using namespace std::chrono_literals;
+
+using Window = TimeWindowBuffer<int>;
+using Time = Window::time_point;
+
+Time at(std::chrono::milliseconds ms) {
+    return Time(ms);
+}
+
+} // namespace
+
+TEST(TIME_WINDOW_BUFFER_TEST, EVICTS_BY_AGE_IN_BULK) {
+    Window window(100ms);
+    for (int i = 0; i < 10; ++i) {
+        window.push(i, at(i * 10ms));
+    }
+    ASSERT_EQ(window.size(), 10);
+    ASSERT_EQ(window.advance(at(90ms)), 0);
+
+    // Entries at exactly now - window stay.
+    ASSERT_EQ(window.advance(at(135ms)), 4);
+    ASSERT_EQ(window.front().time, at(40ms));
+    ASSERT_EQ(window.front().value, 4);
+
+    window.push(100, at(150ms));
+    ASSERT_EQ(window.size(), 6);
+    ASSERT_EQ(window.front().value, 5);
+    ASSERT_EQ(window.back().value, 100);
+
+    ASSERT_EQ(window.advance(at(1000ms)), 6);
+    ASSERT_TRUE(window.empty());
+    ASSERT_EQ(window.advance(at(2000ms)), 0);
+}
+
+TEST(TIME_WINDOW_BUFFER_TEST, MAX_COUNT_AND_WRAPPED_STORAGE) {
+    Window window(1s, 4);
+    for (int i = 0; i < 11; ++i) {
+        window.push(i, at(i * 1ms));
+    }
+    ASSERT_EQ(window.size(), 4);
+    ASSERT_EQ(window.entries().capacity(), 4);
+    int expected = 7;
+    for (const auto& entry: window) {
+        ASSERT_EQ(entry.value, expected++);
+    }
+
+    // The survivors straddle the wrap point of the ring.
+    ASSERT_EQ(window.advance(at(1009ms)), 2);
+    ASSERT_EQ(window.front().value, 9);
+    ASSERT_EQ(sorted::lower_bound(window.entries(), at(10ms), &Window::value_type::time)->value, 10);
+
+    ASSERT_THROW(window.push(0, at(5ms)), std::out_of_range);
+}
+
+TEST(TIME_WINDOW_BUFFER_TEST, MOVE_ONLY_VALUES) {
+    TimeWindowBuffer<std::unique_ptr<int>> window(10ms);
+    window.push(std::make_unique<int>(1), at(0ms));
+    window.emplace(at(5ms), new int(2));
+    window.push(std::make_unique<int>(3), at(15ms));
+    ASSERT_EQ(window.size(), 2);
+    ASSERT_EQ(*window.front().value, 2);
+    window.clear();
+    ASSERT_TRUE(window.empty());
+}
@@ -0,0 +1,72 @@
+#include "lib/TimingWheel.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+
+TEST(TIMING_WHEEL_TEST, FIRES_ON_THE_DEADLINE_TICK) {
+    TimingWheel<int> wheel(100);
+    std::vector<std::pair<std::uint64_t, int>> fired;
+    auto record = [&](int value) { fired.emplace_back(wheel.now(), value); };
+
+    wheel.schedule(105, 1);
+    wheel.schedule(100 + 256, 2);
+    wheel.schedule(100 + 70'000, 3);
+    const auto cancelled = wheel.schedule(200, 4);
+    // Already due: fires on the next tick.
+    wheel.schedule(50, 5);
+    ASSERT_EQ(wheel.size(), 5);
+
+    ASSERT_TRUE(wheel.cancel(cancelled));
+    ASSERT_FALSE(wheel.cancel(cancelled));
+    ASSERT_EQ(wheel.advance(105, record), 2);
+    ASSERT_EQ(wheel.advance(100'000, record), 2);
+    ASSERT_EQ(fired, (std::vector<std::pair<std::uint64_t, int>>{{101, 5}, {105, 1}, {356, 2}, {70'100, 3}}));
+    ASSERT_TRUE(wheel.empty());
+    ASSERT_EQ(wheel.now(), 100'000);
+}
+
+TEST(TIMING_WHEEL_TEST, FIRES_EXACTLY_ONCE_ON_TIME_ACROSS_ALL_LEVELS) {
+    std::mt19937_64 rng(11);
+    TimingWheel<std::uint32_t, 3> wheel(12345);
+    std::vector<std::uint64_t> deadlines;
+    std::vector<TimingWheel<std::uint32_t, 3>::Handle> handles;
+    for (std::uint32_t i = 0; i < 20'000; ++i) {
+        // Up to 2^30 ticks ahead, well past the 2^24 ticks the three levels cover.
+        const int bits = static_cast<int>(rng() % 31);
+        deadlines.push_back(wheel.now() + 1 + (rng() & ((std::uint64_t{1} << bits) - 1)));
+        handles.push_back(wheel.schedule(deadlines.back(), i));
+    }
+    std::vector<bool> cancelled(deadlines.size());
+    for (std::uint32_t i = 0; i < deadlines.size(); i += 3) {
+        ASSERT_TRUE(wheel.cancel(handles[i]));
+        cancelled[i] = true;
+    }
+
+    std::vector<bool> seen(deadlines.size());
+    std::uint64_t errors = 0;
+    std::uint64_t to = wheel.now();
+    while (!wheel.empty()) {
+        to += 1 + rng() % 5'000'000;
+        wheel.advance(to, [&](std::uint32_t i) {
+            errors += cancelled[i] || seen[i] || deadlines[i] != wheel.now();
+            seen[i] = true;
+            // Timers scheduled from a callback land on a later tick.
+            if (i % 7 == 0 && deadlines.size() < 30'000) {
+                deadlines.push_back(wheel.now() + rng() % 1000);
+                cancelled.push_back(false);
+                seen.push_back(false);
+                handles.push_back(wheel.schedule(deadlines.back(), static_cast<std::uint32_t>(deadlines.size() - 1)));
+                deadlines.back() = std::max(deadlines.back(), wheel.now() + 1);
+            }
+        });
+    }
+    ASSERT_EQ(errors, 0);
+    for (std::size_t i = 0; i < deadlines.size(); ++i) {
+        ASSERT_EQ(seen[i], !cancelled[i]) << i;
+    }
+    ASSERT_FALSE(wheel.cancel(handles[1]));
+}
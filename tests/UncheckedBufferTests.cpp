@@ -0,0 +1,32 @@
+#include "lib/CircularBuffer.hpp"
+#include "lib/CircularBufferExt.hpp"
+
+#include <gtest/gtest.h>
+
+
+#ifndef CIRCULAR_BUFFER_UNCHECKED
+#error "This suite checks the CIRCULAR_BUFFER_UNCHECKED build"
+#endif
+
+TEST(UNCHECKED_TEST, REGULAR_OPERATIONS) {
+    CircularBufferExt<int> cb;
+    for (int i = 0; i < 10; ++i) {
+        cb.push_back(i);
+    }
+    cb.erase(cb.cbegin() + 3);
+    cb.insert(cb.cbegin() + 3, 3);
+
+    ASSERT_EQ(cb.front(), 0);
+    ASSERT_EQ(cb.back(), 9);
+    ASSERT_EQ(cb.pop_front(), 0);
+    ASSERT_EQ(cb.cend() - cb.cbegin(), 9);
+}
+
+#ifndef NDEBUG
+TEST(UNCHECKED_TEST, VIOLATIONS_ASSERT_IN_DEBUG) {
+    CircularBuffer<int> cb(2);
+
+    ASSERT_DEATH(cb.front(), "empty buffer");
+    ASSERT_DEATH(cb.pop_back(), "empty buffer");
+}
+#endif
@@ -0,0 +1,78 @@
+#include "lib/WorkStealingDeque.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+
+TEST(WORK_STEALING_DEQUE_TEST, OWNER_IS_LIFO_THIEVES_ARE_FIFO) {
+    WorkStealingDeque<int> deque(2);
+    ASSERT_FALSE(deque.pop().has_value());
+    ASSERT_FALSE(deque.steal().has_value());
+
+    for (int i = 0; i < 10; ++i) {
+        deque.push(i);
+    }
+    ASSERT_EQ(deque.size(), 10);
+    ASSERT_EQ(deque.capacity(), 16);
+    ASSERT_EQ(deque.pop(), 9);
+    ASSERT_EQ(deque.steal(), 0);
+    ASSERT_EQ(deque.steal(), 1);
+
+    // Grow again while the live range sits in the middle of the array.
+    for (int i = 10; i < 30; ++i) {
+        deque.push(i);
+    }
+    ASSERT_EQ(deque.steal(), 2);
+    ASSERT_EQ(deque.pop(), 29);
+    int expected = 28;
+    while (auto value = deque.pop()) {
+        if (expected == 9) {
+            --expected;
+        }
+        ASSERT_EQ(*value, expected--);
+    }
+    ASSERT_EQ(expected, 2);
+    ASSERT_TRUE(deque.empty());
+}
+
+TEST(WORK_STEALING_DEQUE_TEST, EVERY_ELEMENT_IS_TAKEN_EXACTLY_ONCE) {
+    constexpr int kItems = 200'000;
+    constexpr int kThieves = 3;
+    WorkStealingDeque<int> deque(4);
+    auto taken = std::make_unique<std::atomic<int>[]>(kItems);
+    std::atomic<bool> done{false};
+    std::atomic<int> stolen{0};
+
+    auto thief = [&] {
+        while (!done.load(std::memory_order_acquire) || !deque.empty()) {
+            if (auto value = deque.steal()) {
+                taken[*value].fetch_add(1, std::memory_order_relaxed);
+                stolen.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    };
+    std::thread thieves[kThieves] = {std::thread(thief), std::thread(thief), std::thread(thief)};
+
+    // The owner interleaves bursts of pushes with pops, so it contends with the thieves for the last element.
+    for (int next = 0; next < kItems;) {
+        for (int burst = 0; burst < 1 + next % 17 && next < kItems; ++burst) {
+            deque.push(next++);
+        }
+        for (int burst = 0; burst < next % 5; ++burst) {
+            if (auto value = deque.pop()) {
+                taken[*value].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& thread: thieves) {
+        thread.join();
+    }
+
+    for (int i = 0; i < kItems; ++i) {
+        ASSERT_EQ(taken[i].load(), 1) << "item " << i;
+    }
+}